@@ -0,0 +1,89 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace ADS
+{
+	// Tour as the sequence of its nodes and the position of each node: O(1) Next, Prev and Between, O(V) Reverse
+	class ArrayTour
+	{
+	private:
+		vector<unsigned short> order, position;
+
+	public:
+		void Load(const vector<unsigned short> &tour)
+		{
+			order = tour;
+			position.assign(tour.size(), 0);
+
+			for (size_t i = 0; i < order.size(); i++)
+				position[order[i]] = i;
+		}
+
+		void Store(vector<unsigned short> &tour)
+		{
+			tour = order;
+		}
+
+		size_t size()
+		{
+			return order.size();
+		}
+
+		unsigned short Next(unsigned short v)
+		{
+			size_t i = position[v] + 1;
+			return order[i == order.size() ? 0 : i];
+		}
+
+		unsigned short Prev(unsigned short v)
+		{
+			auto i = position[v];
+			return order[i == 0 ? order.size() - 1 : i - 1];
+		}
+
+		// b is met going forward from a to c
+		bool Between(unsigned short a, unsigned short b, unsigned short c)
+		{
+			auto i = position[a], j = position[b], k = position[c];
+
+			return (i <= k ? i <= j && j <= k : i <= j || j <= k);
+		}
+
+		// reverse the path from..to, or the rest of the tour when it is shorter: the cycle is the same
+		void Reverse(unsigned short from, unsigned short to)
+		{
+			const size_t n = order.size();
+
+			size_t i = position[from], j = position[to];
+			size_t length = (j + n - i) % n + 1;
+
+			if (2 * length > n)
+			{
+				i = (j + 1) % n;
+				j = (position[from] + n - 1) % n;
+				length = n - length;
+			}
+
+			for (size_t s = 0; s < length / 2; s++)
+			{
+				swap(order[i], order[j]);
+
+				position[order[i]] = i;
+				position[order[j]] = j;
+
+				i = (i + 1 == n ? 0 : i + 1);
+				j = (j == 0 ? n - 1 : j - 1);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+namespace ADS
+{
+	/*
+	Complete graph on the distance matrix, or on a subset of its vertices, with nothing materialised: O(V) memory.
+	Same adjacency interface as Graph: node u stands for the vertex Vertex(u) of the matrix,
+	its arcs First(u)..First(u + 1) - 1 go to every other node and are decoded from their index.
+	*/
+	class CompleteGraph
+	{
+	private:
+		const vector<vector<float>> &distance;
+
+		// empty for the whole matrix
+		const vector<unsigned short> vertex;
+
+	public:
+		const unsigned short NumberOfNodes;
+
+		CompleteGraph(const vector<vector<float>> &DistanceMatrix2D) : distance(DistanceMatrix2D), NumberOfNodes(DistanceMatrix2D.size()) {}
+
+		CompleteGraph(const vector<vector<float>> &DistanceMatrix2D, const vector<unsigned short> &subset) : distance(DistanceMatrix2D), vertex(subset), NumberOfNodes(subset.size()) {}
+
+		unsigned short Vertex(unsigned short u) const
+		{
+			return (vertex.empty() ? u : vertex[u]);
+		}
+
+		float Cost(unsigned short u, unsigned short v) const
+		{
+			return distance[Vertex(u)][Vertex(v)];
+		}
+
+		// costs from u to every node, contiguous: the matrix row itself, or gathered into buffer on a subset
+		const float *Row(unsigned short u, vector<float> &buffer) const
+		{
+			if (vertex.empty())
+				return distance[u].data();
+
+			buffer.resize(NumberOfNodes);
+
+			for (unsigned short v = 0; v < NumberOfNodes; v++)
+				buffer[v] = Cost(u, v);
+
+			return buffer.data();
+		}
+
+		// the arc i of u goes to i if i < u, to i + 1 otherwise
+		unsigned int First(unsigned short u) const
+		{
+			return (unsigned int)u * (NumberOfNodes - 1);
+		}
+
+		unsigned short Head(unsigned int arc) const
+		{
+			unsigned short u = arc / (NumberOfNodes - 1);
+			unsigned short i = arc % (NumberOfNodes - 1);
+
+			return (i < u ? i : i + 1);
+		}
+
+		float Weight(unsigned int arc) const
+		{
+			return Cost(arc / (NumberOfNodes - 1), Head(arc));
+		}
+
+		unsigned int Degree(unsigned short /*u*/) const
+		{
+			return NumberOfNodes - 1;
+		}
+	};
+}
\ No newline at end of file
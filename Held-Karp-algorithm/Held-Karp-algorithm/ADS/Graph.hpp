@@ -7,26 +7,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #pragma once
 
 #include <algorithm>
-#include <cassert>
-#include <map>
-#include <memory>
-#include <list>
-#include <set>
-#include <stack>
+#include <cfloat>
 #include <vector>
-#include <map>
 
 using namespace std;
 
 namespace ADS
 {
-	enum BlossomLabel
-	{
-		not_setted = 0,
-		even = 1,
-		odd = 2
-	};
-
 	enum Constraints
 	{
 		Free = 0,
@@ -34,228 +21,117 @@ namespace ADS
 		Forbidden = 2
 	};
 
-	struct Node
-	{
-		unsigned short id;
-		shared_ptr<Node> π;
-
-		unsigned short rank = 0; // Kruskal
-		float key = FLT_MAX; // Prim		
-
-
-		// Blossom
-		set<shared_ptr<Node>> B;
-		shared_ptr<Node> mate;
-		bool active = true, pseudo = false, marked = false, blossom = false;
-		BlossomLabel label = not_setted;
-		// Blossom
-	};
-
 	struct Edge
 	{
-		float cost = FLT_MAX;
-		shared_ptr<Node> from, to;
-		Constraints constraint = Free;
+		unsigned short from, to;
+		float cost;
 
-		Edge(float cost_, shared_ptr<Node> from_, shared_ptr<Node> to_) :
-			cost(cost_),
-			from(from_),
-			to(to_)
-		{
-			assert(from_->id != to_->id);
-		}
+		Edge(unsigned short from, unsigned short to, float cost) : from(from), to(to), cost(cost) {}
 	};
 
-	struct Graph
+	/*
+	Graph on the nodes 0..NumberOfNodes - 1: the edge array E and the CSR adjacency of the out-edges, built on first use.
+	The state of the algorithms (keys, parents, ranks) lives in their own arrays.
+	*/
+	class Graph
 	{
-		list<shared_ptr<Node>> V;
-		vector<shared_ptr<Edge>> E; // sortable
-
-		map<unsigned short, int> vrtx_frc, vrtx_frb;
-
-		map<shared_ptr<Node>, list<shared_ptr<Node>>> Adj;
-		vector<vector<unsigned short>> AdjIDs;
+	private:
+		// the out-edges of u are the arcs first[u]..first[u + 1] - 1
+		vector<unsigned int> first;
+		vector<unsigned short> head;
+		vector<float> weight;
 
-		unsigned short NumberOfNodes = 0;
-
-
-		Graph(set<unsigned short> V_)
+		void Build() // O(V + E)
 		{
-			for (auto v : V_)
-				AddNode(v);
-		}
+			first.assign(NumberOfNodes + 1, 0);
 
-		Graph(list<shared_ptr<Node>> V_)
-		{
-			for (auto v : V_)
-				AddNode(v->id);
-		}
-
-		Graph(const vector<vector<float>> &DistanceMatrix2D) : Graph(DistanceMatrix2D.size())
-		{
-			MakeConnected(DistanceMatrix2D);
-		}
-
-		Graph(unsigned short NumberOfNodes_) : Graph(NumberOfNodes_, 0, NumberOfNodes_ - 1) {}
-
-		Graph(unsigned short NumberOfNodes_, unsigned short from, unsigned to)
-		{
-			AdjIDs.resize(NumberOfNodes_);
+			for (auto &e : E)
+				first[e.from + 1]++;
 
-			for (unsigned short d = from; d <= to; d++)
-				AddNode(d);
-		}
+			for (unsigned short u = 0; u < NumberOfNodes; u++)
+				first[u + 1] += first[u];
 
-		void graph_set_edge_cstr(shared_ptr<Edge> ie, Constraints c)
-		{
-			auto c_old = ie->constraint;
-			ie->constraint = c;
+			head.resize(E.size());
+			weight.resize(E.size());
 
-			if (c_old == Forced)
-			{
-				vrtx_frc[ie->from->id]--;
-				vrtx_frc[ie->to->id]--;
-			}
-			else if (c_old == Forbidden)
-			{
-				vrtx_frb[ie->from->id]--;
-				vrtx_frb[ie->to->id]--;
-			}
+			auto next = first;
 
-			if (c == Forced)
-			{
-				vrtx_frc[ie->from->id]++;
-				vrtx_frc[ie->to->id]++;
-			}
-			else if (c == Forbidden)
+			for (auto &e : E)
 			{
-				vrtx_frb[ie->from->id]++;
-				vrtx_frb[ie->to->id]++;
+				head[next[e.from]] = e.to;
+				weight[next[e.from]++] = e.cost;
 			}
 		}
 
-		void AddNode(unsigned short id_)
-		{
-			Node n;
-			n.id = id_;
-
-			V.push_back(make_shared<Node>(n));
-
-			NumberOfNodes++;
-		}
+	public:
+		const unsigned short NumberOfNodes;
+		vector<Edge> E;
 
+		Graph(unsigned short NumberOfNodes) : NumberOfNodes(NumberOfNodes) {}
 
-		void AddEdge(Edge &e)
+		Graph(const vector<vector<float>> &DistanceMatrix2D) : Graph(DistanceMatrix2D.size())
 		{
-			E.push_back(make_shared<Edge>(e));
-			Adj[e.from].push_back(e.to);
-
-			if (AdjIDs.size() > 0)
-				AdjIDs[e.from->id].push_back(e.to->id);
+			MakeConnected(DistanceMatrix2D);
 		}
 
-		void AddEdge(float cost, shared_ptr<Node> from, shared_ptr<Node> to)
+		void AddEdge(float cost, unsigned short from, unsigned short to)
 		{
-			Edge e(cost, from, to);
-			AddEdge(e);
+			E.emplace_back(from, to, cost);
+			first.clear();
 		}
 
-		void AddEdge(float cost, unsigned short from_, unsigned short to_)
+		// both arcs of every pair
+		void MakeConnected(const vector<vector<float>> &DistanceMatrix2D) // Θ(V²)
 		{
-			AddEdge(cost, NodeById(from_), NodeById(to_));
-		}
+			E.reserve(E.size() + (size_t)NumberOfNodes * (NumberOfNodes - 1));
 
-		void MakeConnected(const vector<vector<float>> &DistanceMatrix2D)
-		{
-			for (auto d : V)
-				for (auto a : V)
-					if (d->id != a->id)
-						AddEdge(DistanceMatrix2D[d->id][a->id], d, a);
+			for (unsigned short u = 0; u < NumberOfNodes; u++)
+				for (unsigned short v = 0; v < NumberOfNodes; v++)
+					if (u != v)
+						E.emplace_back(u, v, DistanceMatrix2D[u][v]);
+
+			first.clear();
 		}
 
-		shared_ptr<Node> NodeById(unsigned short id)
+		unsigned int First(unsigned short u)
 		{
-			for (auto v : V)
-				if (v->id == id)
-					return v;
+			if (first.empty())
+				Build();
 
-			return nullptr;
+			return first[u];
 		}
 
-		shared_ptr<Node> GetANode()
+		unsigned short Head(unsigned int arc)
 		{
-			for (auto v : V)
-				return v;
+			return head[arc];
 		}
 
-		void PreVisit(stack<size_t> &R, unsigned short r)
+		float Weight(unsigned int arc)
 		{
-			R.push(r);
-
-			for (auto v : V)
-				if (v->π)
-					if (v->π->id == r)
-						PreVisit(R, v->id);
+			return weight[arc];
 		}
 
-		unsigned short degree_out(shared_ptr<Node> n)
+		unsigned int Degree(unsigned short u)
 		{
-			return Adj[n].size();
+			return First(u + 1) - First(u);
 		}
 
 		void SortEdgeByWeight()
 		{
-			sort(E.begin(), E.end(), [](shared_ptr<Edge> l, shared_ptr<Edge> r) {
-				return l->cost < r->cost;
-			});
-		}
-
-		map<unsigned short, unsigned short> Degree()
-		{
-			map<unsigned short, unsigned short> R;
-
-			for (auto e : E)
+			sort(E.begin(), E.end(), [](const Edge &l, const Edge &r)
 			{
-				R[e->from->id] = 0;
-				R[e->to->id] = 0;
-			}
-
-			for (auto e : E)
-				R[e->from->id]++;
-
-			for (auto e : E)
-				R[e->to->id]++;
-
-			return R;
-		}
-
-		bool HaveCycle()
-		{
-			auto D = Degree();
-
-			for (auto v : V)
-				if (D[v->id] != 2)
-					return false;
-
-			return true;
-		}
-
-		float Cost(const vector<vector<float>> &DistanceMatrix2D)
-		{
-			float cost = 0;
-
-			for (auto e : E)
-				cost += DistanceMatrix2D[e->from->id][e->to->id];
+				return l.cost < r.cost;
+			});
 
-			return cost;
+			first.clear();
 		}
 
 		float Cost()
 		{
 			float cost = 0;
 
-			for (auto e : E)
-				cost += e->cost;
+			for (auto &e : E)
+				cost += e.cost;
 
 			return cost;
 		}
@@ -0,0 +1,135 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace ADS
+{
+	/*
+	Uniform grid over points of the plane, about two per cell, in CSR form.
+	The k nearest of a point are searched in rings of cells around it, stopping when the next ring cannot hold a nearer one:
+	O(k) per point when the points are spread evenly, instead of comparing every pair.
+	*/
+	class PointGrid
+	{
+	private:
+		const vector<pair<float, float>> &point;
+
+		float x0, y0, side;
+		int columns, rows;
+
+		// the points of cell c are index[first[c]..first[c + 1])
+		vector<unsigned int> first;
+		vector<unsigned short> index;
+
+		int Column(float x) const
+		{
+			return min(columns - 1, static_cast<int>((x - x0) / side));
+		}
+
+		int Row(float y) const
+		{
+			return min(rows - 1, static_cast<int>((y - y0) / side));
+		}
+
+		float Distance(unsigned short a, unsigned short b) const
+		{
+			return hypot(point[a].first - point[b].first, point[a].second - point[b].second);
+		}
+
+	public:
+		PointGrid(const vector<pair<float, float>> &points) : point(points)
+		{
+			const auto n = points.size();
+
+			float x1 = 0, y1 = 0;
+			x0 = y0 = 0;
+
+			for (size_t i = 0; i < n; i++)
+			{
+				x0 = (i == 0 ? points[i].first : min(x0, points[i].first));
+				y0 = (i == 0 ? points[i].second : min(y0, points[i].second));
+				x1 = (i == 0 ? points[i].first : max(x1, points[i].first));
+				y1 = (i == 0 ? points[i].second : max(y1, points[i].second));
+			}
+
+			const auto width = max(x1 - x0, y1 - y0);
+			side = (width > 0 ? width / max(1.0f, ceil(sqrt(n / 2.0f))) : 1.0f);
+			columns = static_cast<int>((x1 - x0) / side) + 1;
+			rows = static_cast<int>((y1 - y0) / side) + 1;
+
+			first.assign(columns * rows + 1, 0);
+			index.resize(n);
+
+			for (size_t i = 0; i < n; i++)
+				first[Row(points[i].second) * columns + Column(points[i].first) + 1]++;
+
+			for (size_t c = 1; c < first.size(); c++)
+				first[c] += first[c - 1];
+
+			auto next = first;
+
+			for (size_t i = 0; i < n; i++)
+				index[next[Row(points[i].second) * columns + Column(points[i].first)]++] = static_cast<unsigned short>(i);
+		}
+
+		// the k nearest other points of p, nearest first
+		vector<unsigned short> Nearest(unsigned short p, unsigned short k) const
+		{
+			vector<pair<float, unsigned short>> best;
+
+			if (k == 0)
+				return {};
+
+			const auto c = Column(point[p].first);
+			const auto r = Row(point[p].second);
+			const auto rings = max(columns, rows);
+
+			for (int d = 0; d < rings; d++)
+			{
+				// the cells at Chebyshev distance d from the cell of p
+				for (auto y = max(0, r - d); y <= min(rows - 1, r + d); y++)
+					for (auto x = max(0, c - d); x <= min(columns - 1, c + d); x++)
+					{
+						if (abs(x - c) != d && abs(y - r) != d)
+							continue;
+
+						const auto cell = y * columns + x;
+
+						for (auto i = first[cell]; i < first[cell + 1]; i++)
+							if (index[i] != p)
+								best.emplace_back(Distance(p, index[i]), index[i]);
+					}
+
+				// every point beyond ring d is at least d cells away
+				if (best.size() >= k)
+				{
+					nth_element(best.begin(), best.begin() + (k - 1), best.end());
+					best.resize(k);
+
+					if (best.back().first <= d * side)
+						break;
+				}
+			}
+
+			sort(best.begin(), best.end());
+
+			vector<unsigned short> nearest;
+
+			for (auto &b : best)
+				nearest.push_back(b.second);
+
+			return nearest;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,512 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+Two-level doubly-linked list
+From: Fredman, M. L. and Johnson, D. S. and McGeoch, L. A. and Ostheimer, G., 1995. Data structures for traveling salesmen. Journal of Algorithms, 18(3):432–479.
+*/
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+namespace ADS
+{
+	/*
+	Tour cut in about √V segments. Each segment is a doubly-linked list of nodes with sequence numbers and a reversed bit,
+	the segments form a doubly-linked cycle with increasing ranks, spaced to insert new segments without renumbering.
+	Next, Prev and Between are O(1).
+	Reverse flips the reversed bits and relinks the whole segments of the path, after splitting the two end segments:
+	O(√V), paths inside one segment are reversed node by node.
+	*/
+	class TwoLevelList
+	{
+	private:
+		struct sNode
+		{
+			// neighbours inside the segment, in its own orientation
+			unsigned short prev, next;
+			unsigned int segment;
+			int seq;
+		};
+
+		struct sSegment
+		{
+			// ends in its own orientation: the tour walks first..last, or last..first if reversed
+			unsigned short first, last;
+			unsigned int prev, next, rank, size;
+			bool reversed;
+		};
+
+		vector<sNode> node;
+		vector<sSegment> segment;
+		vector<unsigned int> unused;
+		vector<unsigned short> piece;
+		vector<unsigned int> ranks;
+
+		unsigned int groupSize, segments, head;
+		unsigned short start;
+
+	private:
+		unsigned short TourFirst(unsigned int s)
+		{
+			return segment[s].reversed ? segment[s].last : segment[s].first;
+		}
+
+		unsigned short TourLast(unsigned int s)
+		{
+			return segment[s].reversed ? segment[s].first : segment[s].last;
+		}
+
+		int TourSeq(unsigned short v)
+		{
+			return segment[node[v].segment].reversed ? -node[v].seq : node[v].seq;
+		}
+
+		// a comes before b, counting from the segment of rank 0
+		bool Before(unsigned short a, unsigned short b)
+		{
+			auto ra = segment[node[a].segment].rank, rb = segment[node[b].segment].rank;
+
+			return (ra != rb ? ra < rb : TourSeq(a) <= TourSeq(b));
+		}
+
+		static constexpr unsigned int RankGap = 1024;
+
+		void Renumber()
+		{
+			auto s = head;
+
+			for (unsigned int r = 0; r < segments; r++)
+			{
+				segment[s].rank = r * RankGap;
+				s = segment[s].next;
+			}
+		}
+
+		// rank of the new segment t, just inserted in the cycle
+		void Rank(unsigned int t)
+		{
+			auto p = segment[t].prev, q = segment[t].next;
+
+			if (q == head)
+			{
+				if (segment[p].rank < UINT_MAX - RankGap)
+				{
+					segment[t].rank = segment[p].rank + RankGap;
+					return;
+				}
+			}
+			else if (segment[q].rank - segment[p].rank > 1)
+			{
+				segment[t].rank = segment[p].rank + (segment[q].rank - segment[p].rank) / 2;
+				return;
+			}
+
+			Renumber();
+		}
+
+		unsigned int NewSegment()
+		{
+			if (unused.empty())
+			{
+				segment.emplace_back();
+				unused.push_back(segment.size() - 1);
+			}
+
+			auto s = unused.back();
+			unused.pop_back();
+			segments++;
+
+			return s;
+		}
+
+		// piece, in tour order, becomes the segment s
+		void Fill(unsigned int s)
+		{
+			auto &S = segment[s];
+
+			S.first = piece.front();
+			S.last = piece.back();
+			S.size = piece.size();
+			S.reversed = false;
+
+			for (size_t i = 0; i < piece.size(); i++)
+			{
+				auto &N = node[piece[i]];
+
+				N.segment = s;
+				N.seq = i;
+				N.prev = (i == 0 ? piece[i] : piece[i - 1]);
+				N.next = (i + 1 == piece.size() ? piece[i] : piece[i + 1]);
+			}
+		}
+
+		// add v at the tour end of s
+		void PushBack(unsigned int s, unsigned short v)
+		{
+			auto &S = segment[s];
+			auto &N = node[v];
+
+			if (S.reversed)
+			{
+				N.seq = node[S.first].seq - 1;
+				N.next = S.first;
+				node[S.first].prev = v;
+				S.first = v;
+			}
+			else
+			{
+				N.seq = node[S.last].seq + 1;
+				N.prev = S.last;
+				node[S.last].next = v;
+				S.last = v;
+			}
+
+			N.segment = s;
+			S.size++;
+		}
+
+		// add v at the tour start of s
+		void PushFront(unsigned int s, unsigned short v)
+		{
+			auto &S = segment[s];
+			auto &N = node[v];
+
+			if (S.reversed)
+			{
+				N.seq = node[S.last].seq + 1;
+				N.prev = S.last;
+				node[S.last].next = v;
+				S.last = v;
+			}
+			else
+			{
+				N.seq = node[S.first].seq - 1;
+				N.next = S.first;
+				node[S.first].prev = v;
+				S.first = v;
+			}
+
+			N.segment = s;
+			S.size++;
+		}
+
+		// v becomes the tour start of its segment: the shorter side of the cut moves to a new segment
+		void SplitBefore(unsigned short v)
+		{
+			const auto s = node[v].segment;
+
+			if (v == TourFirst(s))
+				return;
+
+			const unsigned int left = abs(TourSeq(v) - TourSeq(TourFirst(s)));
+			const auto t = NewSegment();
+
+			auto &S = segment[s];
+			auto &T = segment[t];
+
+			piece.clear();
+
+			if (2 * left <= S.size)
+			{
+				for (auto u = TourFirst(s); u != v; u = Next(u))
+					piece.push_back(u);
+
+				(S.reversed ? S.last : S.first) = v;
+
+				T.prev = S.prev;
+				T.next = s;
+				segment[S.prev].next = t;
+				S.prev = t;
+			}
+			else
+			{
+				auto end = Next(TourLast(s));
+				auto p = Prev(v);
+
+				for (auto u = v; u != end; u = Next(u))
+					piece.push_back(u);
+
+				(S.reversed ? S.first : S.last) = p;
+
+				T.next = S.next;
+				T.prev = s;
+				segment[S.next].prev = t;
+				S.next = t;
+			}
+
+			S.size -= piece.size();
+			Fill(t);
+			Rank(t);
+		}
+
+		void SplitAfter(unsigned short v)
+		{
+			if (v != TourLast(node[v].segment))
+				SplitBefore(Next(v));
+		}
+
+		// a..b lies inside one segment, in tour order
+		void ReverseInside(unsigned short a, unsigned short b)
+		{
+			const auto s = node[a].segment;
+			auto &S = segment[s];
+
+			// the block in the segment orientation
+			auto x = (S.reversed ? b : a);
+			auto y = (S.reversed ? a : b);
+
+			const bool hasLeft = (x != S.first), hasRight = (y != S.last);
+			const auto left = node[x].prev, right = node[y].next;
+			const auto seq = node[x].seq;
+
+			piece.clear();
+
+			for (auto u = x; ; u = node[u].next)
+			{
+				piece.push_back(u);
+
+				if (u == y)
+					break;
+			}
+
+			reverse(piece.begin(), piece.end());
+
+			for (size_t i = 0; i < piece.size(); i++)
+			{
+				auto &N = node[piece[i]];
+
+				N.seq = seq + i;
+				N.prev = (i == 0 ? left : piece[i - 1]);
+				N.next = (i + 1 == piece.size() ? right : piece[i + 1]);
+			}
+
+			if (hasLeft)
+				node[left].next = piece.front();
+			else
+				S.first = piece.front();
+
+			if (hasRight)
+				node[right].prev = piece.back();
+			else
+				S.last = piece.back();
+		}
+
+		// the k whole segments from s1 to sk change order and orientation, the ranks keep their places
+		void ReverseSegments(unsigned int s1, unsigned int sk, unsigned int k)
+		{
+			const auto before = segment[s1].prev, after = segment[sk].next;
+
+			ranks.clear();
+
+			auto s = s1;
+			auto first = k;
+
+			for (unsigned int i = 0; i < k; i++)
+			{
+				auto next = segment[s].next;
+
+				ranks.push_back(segment[s].rank);
+
+				if (s == head)
+					first = i;
+
+				swap(segment[s].prev, segment[s].next);
+				segment[s].reversed = !segment[s].reversed;
+
+				s = next;
+			}
+
+			segment[sk].prev = before;
+			segment[before].next = sk;
+			segment[s1].next = after;
+			segment[after].prev = s1;
+
+			s = sk;
+
+			for (unsigned int i = 0; i < k; i++)
+			{
+				segment[s].rank = ranks[i];
+
+				if (i == first)
+					head = s;
+
+				s = segment[s].next;
+			}
+		}
+
+		// a segment under half the group size joins its smaller neighbour, if they stay within twice the group size
+		void Balance(unsigned int s)
+		{
+			auto &S = segment[s];
+
+			if (segments == 1 || 2 * S.size >= groupSize)
+				return;
+
+			const auto p = S.prev, q = S.next;
+			const auto t = (segment[p].size <= segment[q].size ? p : q);
+
+			if (S.size + segment[t].size > 2 * groupSize)
+				return;
+
+			piece.clear();
+
+			for (auto u = TourFirst(s); ; u = Next(u))
+			{
+				piece.push_back(u);
+
+				if (u == TourLast(s))
+					break;
+			}
+
+			if (t == p)
+				for (auto u : piece)
+					PushBack(t, u);
+			else
+				for (auto u = piece.rbegin(); u != piece.rend(); u++)
+					PushFront(t, *u);
+
+			segment[p].next = q;
+			segment[q].prev = p;
+
+			if (head == s)
+				head = t;
+
+			unused.push_back(s);
+			segments--;
+
+			Renumber();
+		}
+
+	public:
+		void Load(const vector<unsigned short> &tour)
+		{
+			const unsigned int n = tour.size();
+
+			groupSize = max<unsigned int>(8, (unsigned int)sqrt(n));
+			segments = 0;
+			head = 0;
+			start = tour[0];
+
+			node.resize(n);
+			segment.clear();
+			unused.clear();
+
+			for (unsigned int i = 0; i < n; i += groupSize)
+			{
+				auto s = NewSegment();
+
+				piece.assign(tour.begin() + i, tour.begin() + min(n, i + groupSize));
+				Fill(s);
+			}
+
+			for (unsigned int s = 0; s < segments; s++)
+			{
+				segment[s].prev = (s == 0 ? segments - 1 : s - 1);
+				segment[s].next = (s + 1 == segments ? 0 : s + 1);
+			}
+
+			Renumber();
+		}
+
+		void Store(vector<unsigned short> &tour)
+		{
+			tour.resize(node.size());
+
+			auto v = start;
+
+			for (auto &t : tour)
+			{
+				t = v;
+				v = Next(v);
+			}
+		}
+
+		size_t size()
+		{
+			return node.size();
+		}
+
+		unsigned short Next(unsigned short v)
+		{
+			auto &S = segment[node[v].segment];
+
+			if (S.reversed)
+				return (v == S.first ? TourFirst(S.next) : node[v].prev);
+			else
+				return (v == S.last ? TourFirst(S.next) : node[v].next);
+		}
+
+		unsigned short Prev(unsigned short v)
+		{
+			auto &S = segment[node[v].segment];
+
+			if (S.reversed)
+				return (v == S.last ? TourLast(S.prev) : node[v].next);
+			else
+				return (v == S.first ? TourLast(S.prev) : node[v].prev);
+		}
+
+		// b is met going forward from a to c
+		bool Between(unsigned short a, unsigned short b, unsigned short c)
+		{
+			return (Before(a, c) ? Before(a, b) && Before(b, c) : Before(a, b) || Before(b, c));
+		}
+
+		// reverse the path from..to, or the rest of the tour when it has fewer segments: the cycle is the same
+		void Reverse(unsigned short from, unsigned short to)
+		{
+			if (from == to)
+				return;
+
+			if (node[from].segment == node[to].segment)
+			{
+				if (TourSeq(from) <= TourSeq(to))
+					ReverseInside(from, to);
+				else if (Next(to) != from)
+					ReverseInside(Next(to), Prev(from));
+
+				return;
+			}
+
+			SplitBefore(from);
+			SplitAfter(to);
+
+			const auto s1 = node[from].segment, sk = node[to].segment;
+
+			auto s = s1;
+			unsigned int k = 1;
+
+			while (s != sk && 2 * k <= segments)
+			{
+				s = segment[s].next;
+				k++;
+			}
+
+			if (s == sk && 2 * k <= segments)
+				ReverseSegments(s1, sk, k);
+			else
+			{
+				k = 0;
+
+				for (s = segment[sk].next; s != s1; s = segment[s].next)
+					k++;
+
+				if (k > 0)
+					ReverseSegments(segment[sk].next, segment[s1].prev, k);
+			}
+
+			Balance(node[from].segment);
+			Balance(node[to].segment);
+			Balance(node[Next(from)].segment);
+			Balance(node[Prev(to)].segment);
+		}
+	};
+}
\ No newline at end of file
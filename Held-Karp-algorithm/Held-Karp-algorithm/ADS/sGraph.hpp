@@ -6,8 +6,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#include "Graph.hpp"
+
 using namespace std;
 
 namespace ADS
@@ -89,36 +95,222 @@ namespace ADS
 		}
 	};
 
-	struct sNode
+	// constraint added to a subproblem, linked to the constraints of its parent (persistent tree)
+	struct sConstraint
 	{
-		float bound = 0;
+		sEdge edge;
+		Constraints type;
+		const sConstraint *parent;
+	};
+
+	/*
+	Block allocator of the constraints. A record is never moved; once Sweep finds no open node reaching it, it is reused.
+	A sweep is due when the records handed out since the last one reach those it kept, so the records in use stay
+	below twice those reachable at the last sweep plus SweepFrom, and every record is walked O(1) times amortised.
+	*/
+	class sConstraintArena
+	{
+	private:
+		static const size_t BlockSize = 4096;
+		static const size_t SweepFrom = 16 * BlockSize;
 
-		vector<float> λ;
-		vector<sEdge> R, F;
-		sTree oneTree;
+		mutex lock;
+		vector<unique_ptr<sConstraint[]>> blocks;
+		size_t used = BlockSize;
 
-		sNode(unsigned short size) : oneTree(size), λ(size) {}
+		// records freed by the last sweep, chained through parent
+		const sConstraint *unused = nullptr;
 
-		sNode(vector<sEdge> R, vector<sEdge> F, vector<float> λ, unsigned short size) : R(R), F(F), λ(λ), oneTree(size) {}
+		// records handed out since the last sweep, and kept by it
+		size_t added = 0, kept = 0;
 
-		bool Forbidden(unsigned short i, unsigned short j)
+	public:
+		const sConstraint *Add(const sConstraint *parent, sEdge edge, Constraints type)
 		{
-			for (auto f : F)
-				if ((f.from == i && f.to == j) || (f.from == j && f.to == i))
-					return true;
+			lock_guard<mutex> guard(lock);
 
-			return false;
+			sConstraint *c;
+
+			if (unused != nullptr)
+			{
+				c = const_cast<sConstraint*>(unused);
+				unused = unused->parent;
+			}
+			else
+			{
+				if (used == BlockSize)
+				{
+					blocks.push_back(unique_ptr<sConstraint[]>(new sConstraint[BlockSize]));
+					used = 0;
+				}
+
+				c = &blocks.back()[used++];
+			}
+
+			added++;
+
+			c->edge = edge;
+			c->type = type;
+			c->parent = parent;
+
+			return c;
+		}
+
+		bool Crowded()
+		{
+			lock_guard<mutex> guard(lock);
+
+			return added >= max(kept, SweepFrom);
+		}
+
+		// roots are the constraints of every open node, the records they do not reach are freed; no Add may run meanwhile
+		void Sweep(const vector<const sConstraint*> &roots)
+		{
+			lock_guard<mutex> guard(lock);
+
+			// blocks by address, to find the index of a record
+			vector<pair<const sConstraint*, size_t>> start;
+
+			for (size_t b = 0; b < blocks.size(); b++)
+				start.emplace_back(blocks[b].get(), b);
+
+			auto before = [](const pair<const sConstraint*, size_t> &l, const pair<const sConstraint*, size_t> &r)
+			{
+				return less<const sConstraint*>()(l.first, r.first);
+			};
+
+			sort(start.begin(), start.end(), before);
+
+			auto index = [&](const sConstraint *c)
+			{
+				auto b = prev(upper_bound(start.begin(), start.end(), make_pair(c, size_t(0)), before));
+				return b->second * BlockSize + (c - b->first);
+			};
+
+			vector<bool> reached(blocks.size() * BlockSize, false);
+			kept = 0;
+
+			// a chain is walked up to the first record reached from another node
+			for (auto c : roots)
+				for (; c != nullptr && !reached[index(c)]; c = c->parent)
+				{
+					reached[index(c)] = true;
+					kept++;
+				}
+
+			unused = nullptr;
+
+			for (size_t b = 0; b < blocks.size(); b++)
+				for (size_t k = 0; k < (b + 1 == blocks.size() ? used : BlockSize); k++)
+					if (!reached[b * BlockSize + k])
+					{
+						blocks[b][k].parent = unused;
+						unused = &blocks[b][k];
+					}
+
+			added = 0;
+		}
+
+		void Clear()
+		{
+			lock_guard<mutex> guard(lock);
+
+			blocks.clear();
+			used = BlockSize;
+			unused = nullptr;
+			added = 0;
+			kept = 0;
+		}
+	};
+
+	// constraints of a subproblem expanded on an edge-state array, O(1) queries
+	struct sConstraintState
+	{
+		const unsigned short n;
+
+		vector<Constraints> state;
+		vector<unsigned short> requiredNeighbor, requiredDegree;
+
+		// constraints shared by every subproblem, restored by Unload
+		const vector<Constraints> *base = nullptr;
+
+		sConstraintState(unsigned short size) : n(size), state(size * size, Free), requiredNeighbor(size, size), requiredDegree(size, 0) {}
+
+		void SetBase(const vector<Constraints> &base_)
+		{
+			base = &base_;
+			state = base_;
 		}
 
-		unsigned short IncidentToRequired(unsigned short v, unsigned short n)
+		void Load(const sConstraint *c)
 		{
-			for (auto r : R)
-				if (v == r.from)
-					return r.to;
-				else if (v == r.to)
-					return r.from;
+			for (; c != nullptr; c = c->parent)
+			{
+				state[c->edge.from * n + c->edge.to] = c->type;
+				state[c->edge.to * n + c->edge.from] = c->type;
+
+				// the first required edge added along the path wins
+				if (c->type == Forced)
+				{
+					requiredNeighbor[c->edge.from] = c->edge.to;
+					requiredNeighbor[c->edge.to] = c->edge.from;
 
-			return n;
+					requiredDegree[c->edge.from]++;
+					requiredDegree[c->edge.to]++;
+				}
+			}
 		}
+
+		void Unload(const sConstraint *c)
+		{
+			for (; c != nullptr; c = c->parent)
+			{
+				auto ij = c->edge.from * n + c->edge.to;
+				auto ji = c->edge.to * n + c->edge.from;
+
+				state[ij] = (base ? (*base)[ij] : Free);
+				state[ji] = (base ? (*base)[ji] : Free);
+
+				requiredNeighbor[c->edge.from] = n;
+				requiredNeighbor[c->edge.to] = n;
+
+				requiredDegree[c->edge.from] = 0;
+				requiredDegree[c->edge.to] = 0;
+			}
+		}
+
+		Constraints State(unsigned short i, unsigned short j) const
+		{
+			return state[i * n + j];
+		}
+
+		bool Forbidden(unsigned short i, unsigned short j) const
+		{
+			return state[i * n + j] == ADS::Forbidden;
+		}
+
+		unsigned short IncidentToRequired(unsigned short v) const
+		{
+			return requiredNeighbor[v];
+		}
+	};
+
+	/*
+	Open subproblem: its bound, its constraints and the multipliers of its best 1-tree.
+	The multipliers are immutable and shared with the parent until the ascent of the node moves them;
+	the 1-tree is not kept, it is rebuilt from them when the node is expanded.
+	*/
+	struct sNode
+	{
+		float bound = 0;
+
+		const sConstraint *constraints = nullptr;
+		shared_ptr<const vector<float>> λ;
+
+		sNode() {}
+
+		sNode(unsigned short size) : λ(make_shared<const vector<float>>(size, 0.0f)) {}
+
+		sNode(const sConstraint *constraints, const shared_ptr<const vector<float>> &λ) : constraints(constraints), λ(λ) {}
 	};
 }
\ No newline at end of file
@@ -6,103 +6,296 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <functional>
-#include <set>
+#include <queue>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PRIM_SSE2
+#include <emmintrin.h>
+#endif
 
 #include "Prim.hpp"
 
 namespace MST
 {
 
-	void Prim::Solve(const vector<vector<float>> &distance, Graph &G, unsigned short r_id) // O(E ㏒ V)
+#ifdef PRIM_SSE2
+	// lanes of a where mask is set, of b elsewhere
+	static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	static inline __m128i Select(__m128i mask, __m128i a, __m128i b)
 	{
-		set<size_t> S; // elements available
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+	// least of the four lanes, the lowest index on ties, as the scalar scan would find it
+	static inline void Reduce(__m128 best, __m128i arg, float &minimum, unsigned short &argmin)
+	{
+		float b[4];
+		int a[4];
+
+		_mm_storeu_ps(b, best);
+		_mm_storeu_si128((__m128i*)a, arg);
+
+		for (auto l = 0; l < 4; l++)
+			if (b[l] < minimum || (b[l] == minimum && a[l] < argmin))
+			{
+				minimum = b[l];
+				argmin = a[l];
+			}
+	}
+#endif
+
+	/*
+	Closed nodes carry open = +∞: their candidate cost is +∞ so they are never relaxed, and key + open hides them from the minimum.
+	Four nodes per SSE2 step, the remainder and the other targets on the scalar loop with the same arithmetic.
+	*/
+	unsigned short Prim::RelaxArgMin(sDenseWorkspace &W, const float *row, const float *λ, float λ_u, int u, unsigned short begin, unsigned short end)
+	{
+		auto key = W.key.data();
+		auto π = W.π.data();
+		auto open = W.open.data();
+
+		auto minimum = FLT_MAX;
+		auto argmin = end;
+		unsigned int i = begin;
+
+#ifdef PRIM_SSE2
+		const auto λ_u4 = _mm_set1_ps(λ_u);
+		const auto u4 = _mm_set1_epi32(u);
+		const auto four = _mm_set1_epi32(4);
+
+		auto best = _mm_set1_ps(FLT_MAX);
+		auto arg = _mm_set1_epi32(end);
+		auto index = _mm_setr_epi32(i, i + 1, i + 2, i + 3);
+
+		for (; i + 4 <= end; i += 4)
+		{
+			auto w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_loadu_ps(row + i), λ_u4), _mm_loadu_ps(λ + i)), _mm_loadu_ps(open + i));
+			auto k = _mm_loadu_ps(key + i);
+			auto p = _mm_loadu_si128((__m128i*)(π + i));
+
+			auto lower = _mm_cmplt_ps(w, k);
+
+			k = Select(lower, w, k);
+			p = Select(_mm_castps_si128(lower), u4, p);
+
+			_mm_storeu_ps(key + i, k);
+			_mm_storeu_si128((__m128i*)(π + i), p);
+
+			auto m = _mm_add_ps(k, _mm_loadu_ps(open + i));
+			auto better = _mm_cmplt_ps(m, best);
 
-		// sorted min queue
-		auto compare = [](shared_ptr<Node> lhs, shared_ptr<Node> rhs)
+			best = Select(better, m, best);
+			arg = Select(_mm_castps_si128(better), index, arg);
+			index = _mm_add_epi32(index, four);
+		}
+
+		Reduce(best, arg, minimum, argmin);
+#endif
+
+		for (; i < end; i++)
 		{
-			return lhs->key < rhs->key;
-		};
+			auto w = row[i] + λ_u + λ[i] + open[i];
+
+			if (w < key[i])
+			{
+				key[i] = w;
+				π[i] = u;
+			}
+
+			if (key[i] + open[i] < minimum)
+			{
+				minimum = key[i] + open[i];
+				argmin = i;
+			}
+		}
+
+		return argmin;
+	}
+
+	unsigned short Prim::ArgMin(sDenseWorkspace &W, unsigned short begin, unsigned short end)
+	{
+		auto key = W.key.data();
+		auto open = W.open.data();
+
+		auto minimum = FLT_MAX;
+		auto argmin = end;
+		unsigned int i = begin;
 
-		set<shared_ptr<Node>, decltype(compare)> Q(compare);
+#ifdef PRIM_SSE2
+		const auto four = _mm_set1_epi32(4);
 
-		for (auto u : G.V)
+		auto best = _mm_set1_ps(FLT_MAX);
+		auto arg = _mm_set1_epi32(end);
+		auto index = _mm_setr_epi32(i, i + 1, i + 2, i + 3);
+
+		for (; i + 4 <= end; i += 4)
 		{
-			u->key = FLT_MAX;
-			u->π = nullptr;
+			auto m = _mm_add_ps(_mm_loadu_ps(key + i), _mm_loadu_ps(open + i));
+			auto better = _mm_cmplt_ps(m, best);
 
-			S.insert(u->id);
+			best = Select(better, m, best);
+			arg = Select(_mm_castps_si128(better), index, arg);
+			index = _mm_add_epi32(index, four);
 		}
 
-		auto r = G.NodeById(r_id);
-		r->key = 0;
-		Q.insert(r);
+		Reduce(best, arg, minimum, argmin);
+#endif
+
+		for (; i < end; i++)
+			if (key[i] + open[i] < minimum)
+			{
+				minimum = key[i] + open[i];
+				argmin = i;
+			}
+
+		return argmin;
+	}
+
+	// binary heap with lazy deletion: a node may be queued with stale keys, only its first extraction counts
+	template <class TGraph>
+	vector<unsigned short> Prim::Solve(TGraph &G, unsigned short r) // O(E ㏒ V)
+	{
+		const auto n = G.NumberOfNodes;
+
+		vector<float> key(n, FLT_MAX);
+		vector<unsigned short> π(n, UINT16_MAX);
+		vector<bool> done(n, false);
+
+		priority_queue<pair<float, unsigned short>, vector<pair<float, unsigned short>>, greater<pair<float, unsigned short>>> Q;
+
+		key[r] = 0;
+		Q.emplace(0, r);
 
 		while (!Q.empty())
 		{
-			auto u = *Q.begin(); // min
-			Q.erase(u);
-			S.erase(u->id);
+			auto u = Q.top().second; // min
+			Q.pop();
+
+			if (done[u])
+				continue;
 
-			for (auto v : G.Adj[u])
-				if (u->id != v->id)
-					if (S.count(v->id) && distance[u->id][v->id] < v->key)
-					{
-						Q.erase(v);
+			done[u] = true;
 
-						v->π = u;
-						v->key = distance[u->id][v->id];
+			for (auto a = G.First(u); a < G.First(u + 1); a++)
+			{
+				auto v = G.Head(a);
 
-						Q.insert(v);
-					}
+				if (!done[v] && G.Weight(a) < key[v])
+				{
+					π[v] = u;
+					key[v] = G.Weight(a);
+
+					Q.emplace(key[v], v);
+				}
+			}
 		}
+
+		return π;
 	}
 
-	bool Prim::Solve(sTree &sTree, vector<vector<unsigned short>> &omitted, const vector<vector<float>> &Weights, const unsigned short req, const unsigned short numberOfNodes)
+	template vector<unsigned short> Prim::Solve<Graph>(Graph &G, unsigned short r);
+
+	// no heap: every step relaxes the row of the last node added and picks the least key, O(V²)
+	vector<unsigned short> Prim::Solve(CompleteGraph &G, unsigned short r)
 	{
-		vector<bool> visited(numberOfNodes, 0);
-		vector<pair<float, unsigned short>> min(numberOfNodes, make_pair(FLT_MAX, 0));
+		const auto n = G.NumberOfNodes;
+
+		sDenseWorkspace W(n);
+		vector<float> λ(n, 0), buffer;
+
+		fill(W.key.begin(), W.key.end(), FLT_MAX);
+		fill(W.π.begin(), W.π.end(), UINT16_MAX);
+
+		W.open[r] = INFINITY;
+
+		for (auto u = r; ;)
+		{
+			u = RelaxArgMin(W, G.Row(u, buffer), λ.data(), 0, u, 0, n);
+
+			if (u == n)
+				break;
+
+			W.open[u] = INFINITY;
+		}
+
+		return vector<unsigned short>(W.π.begin(), W.π.end());
+	}
+
+	// Spanning tree of the nodes 1..n-1 on the costs distance[i][j] + λ[i] + λ[j], O(V²) without heap.
+	// Required edges of S enter first, forbidden ones never; true if the tree cannot honour S.
+	// With candidates only the listed neighbours of a node are relaxed.
+	bool Prim::Solve(sTree &sTree, sDenseWorkspace &W, const vector<vector<float>> &distance, const vector<float> &λ, const sConstraintState &S, const unsigned short req, const vector<vector<unsigned short>> *candidates)
+	{
+		const auto numberOfNodes = S.n;
+
+		auto &key = W.key;
+		auto &π = W.π;
+		auto &open = W.open;
 
 		unsigned short req_num = 0;
 		unsigned short vertex = 1;
-		unsigned short new_vertex = 1;
-		float minimum = FLT_MAX;
 
-		visited[1] = 1;
+		for (unsigned short i = 2; i < numberOfNodes; i++)
+		{
+			key[i] = FLT_MAX;
+			open[i] = 0;
+		}
+
+		open[1] = INFINITY;
 
 		for (unsigned short j = 0; j < numberOfNodes - 2; j++)
 		{
-			for (unsigned short i = 2; i < numberOfNodes; i++)
-				if (i != vertex && !visited[i])
-					if (omitted[i][vertex] == 1)
-					{
-						min[i].first = 0;
-						min[i].second = vertex;
-					}
-					else if (omitted[i][vertex] == 0 && Weights[i][vertex] < min[i].first)
-					{
-						min[i].first = Weights[i][vertex];
-						min[i].second = vertex;
-					}
-
-			for (unsigned short i = 2; i < numberOfNodes; i++)
-				if (!visited[i] && min[i].first < minimum)
+			const auto &row = distance[vertex];
+			const auto λ_vertex = λ[vertex];
+
+			auto relax = [&](unsigned short i)
+			{
+				auto c = S.State(i, vertex);
+
+				if (c == Forced)
+				{
+					key[i] = 0;
+					π[i] = vertex;
+				}
+				else if (c == Free && row[i] + λ_vertex + λ[i] < key[i])
 				{
-					minimum = min[i].first;
-					new_vertex = i;
+					key[i] = row[i] + λ_vertex + λ[i];
+					π[i] = vertex;
 				}
+			};
+
+			if (candidates)
+			{
+				for (auto i : (*candidates)[vertex])
+					if (i > 1 && open[i] == 0)
+						relax(i);
+			}
+			else
+			{
+				for (unsigned short i = 2; i < numberOfNodes; i++)
+					if (open[i] == 0)
+						relax(i);
+			}
+
+			auto new_vertex = ArgMin(W, 2, numberOfNodes);
 
-			if (new_vertex == vertex)
+			if (new_vertex == numberOfNodes)
 				return true;
 
-			if (omitted[new_vertex].at(min[new_vertex].second))
+			if (S.State(new_vertex, π[new_vertex]) == Forced)
 				req_num++;
 
 			vertex = new_vertex;
-			visited[vertex] = 1;
+			open[vertex] = INFINITY;
 
-			sTree[j] = sEdge(vertex, min[vertex].second);
-			minimum = FLT_MAX;
+			sTree[j] = sEdge(vertex, π[vertex]);
 		}
 
 		if (req_num < req)
@@ -111,4 +304,32 @@ namespace MST
 		return false;
 	}
 
+	// Spanning tree of the nodes 1..n-1 on the costs distance[i][j] + λ[i] + λ[j] without constraints, O(V²)
+	void Prim::Solve(sTree &sTree, sDenseWorkspace &W, const vector<vector<float>> &distance, const vector<float> &λ)
+	{
+		const unsigned short numberOfNodes = distance.size();
+
+		auto &key = W.key;
+		auto &π = W.π;
+		auto &open = W.open;
+
+		unsigned short vertex = 1;
+
+		for (unsigned short i = 2; i < numberOfNodes; i++)
+		{
+			key[i] = FLT_MAX;
+			open[i] = 0;
+		}
+
+		open[1] = INFINITY;
+
+		for (unsigned short j = 0; j < numberOfNodes - 2; j++)
+		{
+			vertex = RelaxArgMin(W, distance[vertex].data(), λ.data(), λ[vertex], vertex, 2, numberOfNodes);
+			open[vertex] = INFINITY;
+
+			sTree[j] = sEdge(vertex, π[vertex]);
+		}
+	}
+
 }
\ No newline at end of file
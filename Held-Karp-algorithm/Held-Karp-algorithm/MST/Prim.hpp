@@ -8,6 +8,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vector>
 
+#include "../ADS/CompleteGraph.hpp"
 #include "../ADS/Graph.hpp"
 #include "../ADS/SGraph.hpp"
 
@@ -16,11 +17,34 @@ using namespace ADS;
 
 namespace MST
 {
+	// arrays of the dense Prim, allocated once and reused; open is 0 for the nodes still out of the tree, +∞ for the others
+	struct sDenseWorkspace
+	{
+		vector<float> key;
+		vector<int> π;
+		vector<float> open;
+
+		sDenseWorkspace(unsigned short size) : key(size), π(size), open(size) {}
+	};
+
 	class Prim
 	{
+	private:
+		// key[i] = min(key[i], row[i] + λ_u + λ[i]) on begin..end - 1, then the open node of least key, end if none is below FLT_MAX
+		static unsigned short RelaxArgMin(sDenseWorkspace &W, const float *row, const float *λ, float λ_u, int u, unsigned short begin, unsigned short end);
+
+		// the open node of least key on begin..end - 1, end if none is below FLT_MAX
+		static unsigned short ArgMin(sDenseWorkspace &W, unsigned short begin, unsigned short end);
+
 	public:
-		void Solve(const vector<vector<float>> &distance, Graph &G, unsigned short r_id);
-		bool Solve(sTree &tree, vector<vector<unsigned short>> &omitted, const vector<vector<float>> &Weights, const unsigned short req, const unsigned short numberOfNodes);
+		// parent of each node in the tree rooted at r, UINT16_MAX for r and the nodes out of its component; TGraph is Graph
+		template <class TGraph>
+		vector<unsigned short> Solve(TGraph &G, unsigned short r);
+
+		// the same on a complete graph, O(V²) on flat arrays
+		vector<unsigned short> Solve(CompleteGraph &G, unsigned short r);
+		bool Solve(sTree &tree, sDenseWorkspace &W, const vector<vector<float>> &distance, const vector<float> &λ, const sConstraintState &S, const unsigned short req, const vector<vector<unsigned short>> *candidates = nullptr);
+		void Solve(sTree &tree, sDenseWorkspace &W, const vector<vector<float>> &distance, const vector<float> &λ);
 
 	};
 }
\ No newline at end of file
@@ -6,261 +6,410 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <climits>
 
 #include "Blossom.hpp"
 
 namespace Matching
 {
+	Blossom::sArc &Blossom::G(unsigned short u, unsigned short v)
+	{
+		return g[u * N + v];
+	}
 
-	set<shared_ptr<Node>> Blossom::FindBlossom(shared_ptr<Node> p, shared_ptr<Node> i, shared_ptr<Node> j)
+	// slack of the edge in the dual, doubled
+	long long Blossom::Delta(const sArc &e)
 	{
-		set<shared_ptr<Node>> B;
+		return lab[e.u] + lab[e.v] - 2ll * G(e.u, e.v).w;
+	}
 
-		for (auto k : G->V)
-			k->blossom = false;
+	void Blossom::UpdateSlack(unsigned short u, unsigned short x)
+	{
+		if (!slack[x] || Delta(G(u, x)) < Delta(G(slack[x], x)))
+			slack[x] = u;
+	}
 
-		auto k = i;
-		k->blossom = true;
+	void Blossom::SetSlack(unsigned short x)
+	{
+		slack[x] = 0;
 
-		do
-		{
-			k = k->π;
-			k->blossom = true;
-		} while (k != p);
+		for (unsigned short u = 1; u <= n; u++)
+			if (G(u, x).w > 0 && st[u] != x && S[st[u]] == 0)
+				UpdateSlack(u, x);
+	}
+
+	void Blossom::Push(unsigned short x)
+	{
+		if (x <= n)
+			q.push(x);
+		else
+			for (auto y : flo[x])
+				Push(y);
+	}
 
-		k = j;
+	void Blossom::SetBase(unsigned short x, unsigned short b)
+	{
+		st[x] = b;
 
-		do
-		{
-			k->blossom = true;
-			k = k->π;
-		} while (!k->blossom);
+		if (x > n)
+			for (auto y : flo[x])
+				SetBase(y, b);
+	}
 
-		auto w = k;
+	// even position of xr in the cycle of b, reversing the cycle if needed
+	size_t Blossom::Position(unsigned short b, unsigned short xr)
+	{
+		auto pr = find(flo[b].begin(), flo[b].end(), xr) - flo[b].begin();
 
-		do
+		if (pr % 2 == 1)
 		{
-			k = k->π;
-			k->blossom = false;
-		} while (k != p);
-
-		for (auto k : G->V)
-			if (k->blossom)
-			{
-				B.insert(k);
-				k->active = false;
-			}
+			reverse(flo[b].begin() + 1, flo[b].end());
+			return flo[b].size() - pr;
+		}
 
-		return B;
+		return pr;
 	}
 
-	void Blossom::Contract(shared_ptr<Node> p, shared_ptr<Node> i, shared_ptr<Node> j)
+	void Blossom::SetMatch(unsigned short u, unsigned short v)
 	{
-		shared_ptr<Node> b; // memory node
-
-		b->B = FindBlossom(p, i, j);
-		b->pseudo = true;
+		match[u] = G(u, v).v;
 
-		V_.push_back(b);
-		Adj_[b].clear();
+		if (u <= n)
+			return;
 
-		for (auto k : G->V)
-			k->marked = false;
+		auto e = G(u, v);
+		auto xr = flo_from[u * (n + 1) + e.u];
+		auto pr = Position(u, xr);
 
-		for (auto y : b->B)
-			for (auto k : Adj_[y])
-				k->marked = true;
+		for (size_t i = 0; i < pr; i++)
+			SetMatch(flo[u][i], flo[u][i ^ 1]);
 
-		for (auto k : G->V)
-			if (k->marked)
-			{
-				Adj_[b].push_back(j);
-				Adj_[j].push_back(b);
-			}
+		SetMatch(xr, v);
+		rotate(flo[u].begin(), flo[u].begin() + pr, flo[u].end());
 	}
 
-	shared_ptr<Node> Blossom::ExamineEven(shared_ptr<Node> p, shared_ptr<Node> i, bool &found)
+	void Blossom::Augment(unsigned short u, unsigned short v)
 	{
-		for (auto j : Adj_[i])
+		while (true)
 		{
-			if (j->label == BlossomLabel::even)
-			{
-				Contract(p, i, j);
+			auto xnv = st[match[u]];
+			SetMatch(u, v);
 
-				return nullptr;
-			}
+			if (!xnv)
+				return;
 
-			if (j->active && j->mate == nullptr)
-			{
-				auto q = j;
-				q->π = i;
-				found = true;
+			SetMatch(xnv, st[pa[xnv]]);
+			u = st[pa[xnv]];
+			v = xnv;
+		}
+	}
 
-				return q;
-			}
+	unsigned short Blossom::LCA(unsigned short u, unsigned short v)
+	{
+		for (++stamp; u || v; swap(u, v))
+		{
+			if (u == 0)
+				continue;
 
-			if (j->active && j->label == BlossomLabel::not_setted)
-			{
-				j->π = i;
-				j->label = BlossomLabel::odd;
+			if (vis[u] == stamp)
+				return u;
 
-				L.push(j);
-			}
+			vis[u] = stamp;
+			u = st[match[u]];
+
+			if (u)
+				u = st[pa[u]];
 		}
 
-		return nullptr;
+		return 0;
 	}
 
-	void Blossom::ExamineOdd(shared_ptr<Node> p, shared_ptr<Node> i)
+	// the odd cycle u..lca..v becomes a new blossom
+	void Blossom::Contract(unsigned short u, unsigned short lca, unsigned short v)
 	{
-		auto j = i->mate;
+		unsigned short b = n + 1;
 
-		if (j->label == BlossomLabel::odd)
-		{
-			j->π = i;
-			Contract(p, i, j);
+		while (b <= n_x && st[b])
+			b++;
 
-			return;
-		}
+		if (b > n_x)
+			n_x++;
+
+		lab[b] = 0;
+		S[b] = 0;
+		match[b] = match[lca];
+
+		flo[b].clear();
+		flo[b].push_back(lca);
 
-		if (j->mate == nullptr && j->label == BlossomLabel::not_setted)
+		for (unsigned short x = u, y; x != lca; x = st[pa[y]])
 		{
-			j->π = i;
-			j->label = BlossomLabel::even;
+			flo[b].push_back(x);
+			flo[b].push_back(y = st[match[x]]);
+			Push(y);
+		}
+
+		reverse(flo[b].begin() + 1, flo[b].end());
 
-			L.push(j);
+		for (unsigned short x = v, y; x != lca; x = st[pa[y]])
+		{
+			flo[b].push_back(x);
+			flo[b].push_back(y = st[match[x]]);
+			Push(y);
 		}
-	}
 
-	void Blossom::Search(shared_ptr<Node> p)
-	{
-		auto found = false;
-		shared_ptr<Node> q;
+		SetBase(b, b);
 
-		V_ = G->V;
-		Adj_ = G->Adj;
+		for (unsigned short x = 1; x <= n_x; x++)
+		{
+			G(b, x).w = 0;
+			G(x, b).w = 0;
+		}
 
-		p->label = BlossomLabel::even;
-		L.push(p);
+		for (unsigned short x = 1; x <= n; x++)
+			flo_from[b * (n + 1) + x] = 0;
 
-		while (!L.empty() && !found)
+		for (auto xs : flo[b])
 		{
-			auto i = L.top();
-			L.pop();
+			for (unsigned short x = 1; x <= n_x; x++)
+				if (G(b, x).w == 0 || Delta(G(xs, x)) < Delta(G(b, x)))
+				{
+					G(b, x) = G(xs, x);
+					G(x, b) = G(x, xs);
+				}
 
-			if (i->label == BlossomLabel::even)
-				q = ExamineEven(p, i, found);
-			else
-				ExamineOdd(p, i);
+			for (unsigned short x = 1; x <= n; x++)
+				if (flo_from[xs * (n + 1) + x])
+					flo_from[b * (n + 1) + x] = xs;
 		}
 
-		if (found)
-			Augment(p, q);
+		SetSlack(b);
 	}
 
-	shared_ptr<Node> Blossom::FindMarked(list<shared_ptr<Node>> Z)
+	// an inner blossom with zero dual is dissolved into its cycle
+	void Blossom::Expand(unsigned short b)
 	{
-		for (auto z : Z)
-			if (z->marked)
-				return z;
+		for (auto x : flo[b])
+			SetBase(x, x);
 
-		return nullptr;
-	}
+		auto xr = flo_from[b * (n + 1) + G(b, pa[b]).u];
+		auto pr = Position(b, xr);
 
-	void Blossom::ExpandPred(shared_ptr<Node> k)
-	{
-		auto b = k->π;
+		for (size_t i = 0; i < pr; i += 2)
+		{
+			auto xs = flo[b][i];
+			auto xns = flo[b][i + 1];
+
+			pa[xs] = G(xns, xs).u;
+			S[xs] = 1;
+			S[xns] = 0;
+			slack[xs] = 0;
+			SetSlack(xns);
+			Push(xns);
+		}
 
-		for (auto i : V_)
-			i->marked = false;
+		S[xr] = 1;
+		pa[xr] = pa[b];
 
-		for (auto i : b->B)
-			i->marked = true;
+		for (size_t i = pr + 1; i < flo[b].size(); i++)
+		{
+			auto xs = flo[b][i];
+			S[xs] = -1;
+			SetSlack(xs);
+		}
 
-		auto j = FindMarked(Adj_[k]);
-		k->π = j;
+		st[b] = 0;
 	}
 
-	bool Blossom::SetContainsThisEdge(set<shared_ptr<Edge>> S, shared_ptr<Edge> e)
+	// true if the tight edge e completes an augmenting path
+	bool Blossom::FoundEdge(const sArc &e)
 	{
-		for (auto x : S)
-			if (x->from == e->from ||
-				x->to == e->to ||
-				x->from == e->to ||
-				x->to == e->from)
-				return true;
+		auto u = st[e.u];
+		auto v = st[e.v];
 
-		return false;
-	}
+		if (S[v] == -1)
+		{
+			pa[v] = e.u;
+			S[v] = 1;
+
+			auto nu = st[match[v]];
+			slack[v] = 0;
+			slack[nu] = 0;
+			S[nu] = 0;
+			Push(nu);
+		}
+		else if (S[v] == 0)
+		{
+			auto lca = LCA(u, v);
 
-	set<shared_ptr<Edge>> Blossom::SymmetricDifference(set<shared_ptr<Edge>> &S1, set<shared_ptr<Edge>> &S2)
-	{
-		set<shared_ptr<Edge>> symmetricDifference;
+			if (!lca)
+			{
+				Augment(u, v);
+				Augment(v, u);
 
-		for (auto e : S1)
-			symmetricDifference.insert(e);
+				return true;
+			}
 
-		for (auto e : S2)
-			if (!SetContainsThisEdge(S1, e))
-				symmetricDifference.insert(e);
+			Contract(u, lca, v);
+		}
 
-		return symmetricDifference;
+		return false;
 	}
 
-	void Blossom::Augment(shared_ptr<Node> p, shared_ptr<Node> q)
+	// grow the alternating forest and adjust the duals until a matching edge is added
+	bool Blossom::Phase()
 	{
-		set<shared_ptr<Edge>> P;
-		auto k = q;
+		fill(S.begin() + 1, S.begin() + n_x + 1, -1);
+		fill(slack.begin() + 1, slack.begin() + n_x + 1, 0);
+		q = queue<unsigned short>();
 
-		do
-		{
-			if (k->π->pseudo)
+		for (unsigned short x = 1; x <= n_x; x++)
+			if (st[x] == x && !match[x])
 			{
-				ExpandPred(k);
+				pa[x] = 0;
+				S[x] = 0;
+				Push(x);
 			}
-			else
+
+		if (q.empty())
+			return false;
+
+		while (true)
+		{
+			while (!q.empty())
 			{
-				Edge e(0, k->π, k);
-				P.insert(make_shared<Edge>(e));
-				k = k->π;
+				auto u = q.front();
+				q.pop();
+
+				if (S[st[u]] == 1)
+					continue;
+
+				for (unsigned short v = 1; v <= n; v++)
+					if (G(u, v).w > 0 && st[u] != st[v])
+					{
+						if (Delta(G(u, v)) == 0)
+						{
+							if (FoundEdge(G(u, v)))
+								return true;
+						}
+						else
+						{
+							UpdateSlack(u, st[v]);
+						}
+					}
 			}
-		} while (k != p);
 
-		M = SymmetricDifference(M, P);
-	}
+			auto d = LLONG_MAX;
 
+			for (unsigned short b = n + 1; b <= n_x; b++)
+				if (st[b] == b && S[b] == 1)
+					d = min(d, lab[b] / 2);
 
-	set<shared_ptr<Edge>> Blossom::Solve(shared_ptr<Graph> graph)
-	{
-		set<unsigned short> done;
+			for (unsigned short x = 1; x <= n_x; x++)
+				if (st[x] == x && slack[x])
+				{
+					if (S[x] == -1)
+						d = min(d, Delta(G(slack[x], x)));
+					else if (S[x] == 0)
+						d = min(d, Delta(G(slack[x], x)) / 2);
+				}
 
-		G = graph;
+			for (unsigned short u = 1; u <= n; u++)
+				if (S[st[u]] == 0)
+				{
+					if (lab[u] <= d)
+						return false;
 
-	reiterate:
-		for (auto p : G->V)
-			if (done.count(p->id) == 0)
-			{
-				done.insert(p->id);
+					lab[u] -= d;
+				}
+				else if (S[st[u]] == 1)
+				{
+					lab[u] += d;
+				}
 
-				if (p->mate == nullptr)
+			for (unsigned short b = n + 1; b <= n_x; b++)
+				if (st[b] == b)
 				{
-					Search(p);
+					if (S[st[b]] == 0)
+						lab[b] += d * 2;
+					else if (S[st[b]] == 1)
+						lab[b] -= d * 2;
+				}
 
-					if (p->mate == nullptr)
-					{
-						G->V.remove(p);
-						G->Adj.erase(p);
+			q = queue<unsigned short>();
 
-						for (auto v : G->V)
-							G->Adj[v].remove(p);
+			for (unsigned short x = 1; x <= n_x; x++)
+				if (st[x] == x && slack[x] && st[slack[x]] != x && Delta(G(slack[x], x)) == 0)
+					if (FoundEdge(G(slack[x], x)))
+						return true;
 
-						G->NumberOfNodes--;
-						goto reiterate;
-					}
-				}
+			for (unsigned short b = n + 1; b <= n_x; b++)
+				if (st[b] == b && S[b] == 1 && lab[b] == 0)
+					Expand(b);
+		}
+
+		return false;
+	}
+
+	/*
+	The costs are turned into positive integer weights w = 1 + (max - cost)·scale: on a complete graph a maximum weight matching
+	with positive weights is perfect, and it is of minimum cost up to the rounding of 2²⁸ steps.
+	From: Galil, Z., 1986. Efficient algorithms for finding maximum matching in graphs. ACM Computing Surveys, 18(1):23–38.
+	*/
+	vector<pair<unsigned short, unsigned short>> Blossom::Solve(const ADS::CompleteGraph &K) // O(V³)
+	{
+		n = K.NumberOfNodes;
+		n_x = n;
+		N = 2 * n + 1;
+
+		g.assign(N * N, sArc{ 0, 0, 0 });
+		lab.assign(N, 0);
+		match.assign(N, 0);
+		slack.assign(N, 0);
+		st.assign(N, 0);
+		pa.assign(N, 0);
+		S.assign(N, -1);
+		vis.assign(N, 0);
+		flo.assign(N, vector<unsigned short>());
+		flo_from.assign(N * (n + 1), 0);
+
+		float maxCost = 0;
+
+		for (unsigned short u = 0; u < n; u++)
+			for (unsigned short v = 0; v < n; v++)
+				if (u != v)
+					maxCost = max(maxCost, K.Cost(u, v));
+
+		const double scale = (maxCost > 0 ? (1 << 28) / double(maxCost) : 0);
+
+		int w_max = 0;
+
+		for (unsigned short u = 1; u <= n; u++)
+			for (unsigned short v = 1; v <= n; v++)
+			{
+				auto w = (u == v ? 0 : 1 + int((maxCost - K.Cost(u - 1, v - 1)) * scale + 0.5));
+
+				G(u, v) = sArc{ u, v, w };
+				flo_from[u * (n + 1) + v] = (u == v ? u : 0);
+				w_max = max(w_max, w);
 			}
 
+		for (unsigned short u = 0; u <= n; u++)
+			st[u] = u;
+
+		for (unsigned short u = 1; u <= n; u++)
+			lab[u] = w_max;
+
+		while (Phase());
+
+		vector<pair<unsigned short, unsigned short>> M;
+
+		for (unsigned short u = 1; u <= n; u++)
+			if (match[u] && match[u] < u)
+				M.push_back(make_pair(K.Vertex(match[u] - 1), K.Vertex(u - 1)));
+
 		return M;
 	}
+
 }
\ No newline at end of file
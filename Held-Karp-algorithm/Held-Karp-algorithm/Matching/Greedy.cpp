@@ -0,0 +1,139 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <algorithm>
+
+#include "Greedy.hpp"
+
+namespace Matching
+{
+	Greedy::Greedy(unsigned short neighbours) : k(neighbours) {}
+
+	vector<pair<unsigned short, unsigned short>> Greedy::Solve(const ADS::CompleteGraph &G, const vector<vector<unsigned short>> *candidates)
+	{
+		const unsigned short n = G.NumberOfNodes;
+
+		if (n == 0)
+			return {};
+
+		const unsigned short K = min<unsigned short>(k, n - 1);
+
+		auto d = [&](unsigned short a, unsigned short b)
+		{
+			return G.Cost(a, b);
+		};
+
+		// candidate neighbours, nodes of G: the given ones or the k nearest
+		vector<vector<unsigned short>> near(n);
+
+		if (candidates)
+		{
+			near = *candidates;
+		}
+		else
+		{
+			vector<unsigned short> others;
+
+			for (unsigned short a = 0; a < n; a++)
+			{
+				others.clear();
+
+				for (unsigned short b = 0; b < n; b++)
+					if (b != a)
+						others.push_back(b);
+
+				partial_sort(others.begin(), others.begin() + K, others.end(), [&](unsigned short x, unsigned short y) {
+					return d(a, x) < d(a, y);
+				});
+
+				near[a].assign(others.begin(), others.begin() + K);
+			}
+		}
+
+		// greedy on the candidate edges, cheapest first; the lists need not be symmetric
+		vector<pair<unsigned short, unsigned short>> E;
+
+		for (unsigned short a = 0; a < n; a++)
+			for (auto b : near[a])
+				if (a != b)
+					E.push_back(make_pair(min(a, b), max(a, b)));
+
+		sort(E.begin(), E.end(), [&](pair<unsigned short, unsigned short> &l, pair<unsigned short, unsigned short> &r) {
+			auto dl = d(l.first, l.second);
+			auto dr = d(r.first, r.second);
+
+			return dl < dr || (dl == dr && l < r);
+		});
+
+		E.erase(unique(E.begin(), E.end()), E.end());
+
+		vector<unsigned short> mate(n, n);
+
+		for (auto e : E)
+			if (mate[e.first] == n && mate[e.second] == n)
+			{
+				mate[e.first] = e.second;
+				mate[e.second] = e.first;
+			}
+
+		// the few vertices left out of the candidates take their nearest one among them
+		vector<unsigned short> left;
+
+		for (unsigned short a = 0; a < n; a++)
+			if (mate[a] == n)
+				left.push_back(a);
+
+		for (auto a : left)
+			if (mate[a] == n)
+			{
+				auto best = n;
+
+				for (auto b : left)
+					if (b != a && mate[b] == n && (best == n || d(a, b) < d(a, best)))
+						best = b;
+
+				mate[a] = best;
+				mate[best] = a;
+			}
+
+		// 2-opt: the pairs (a, mate a) and (c, mate c), c near a, are exchanged for (a, c) and (mate a, mate c)
+		for (auto improved = true; improved;)
+		{
+			improved = false;
+
+			for (unsigned short a = 0; a < n; a++)
+				for (auto c : near[a])
+				{
+					auto b = mate[a];
+					auto e = mate[c];
+
+					if (c == a || c == b)
+						continue;
+
+					if (d(a, c) + d(b, e) < (d(a, b) + d(c, e)) * (1 - 1e-6f))
+					{
+						mate[a] = c;
+						mate[c] = a;
+						mate[b] = e;
+						mate[e] = b;
+
+						improved = true;
+					}
+				}
+		}
+
+		vector<pair<unsigned short, unsigned short>> M;
+
+		for (unsigned short a = 0; a < n; a++)
+			if (a < mate[a])
+				M.push_back(make_pair(G.Vertex(a), G.Vertex(mate[a])));
+
+		return M;
+	}
+
+}
\ No newline at end of file
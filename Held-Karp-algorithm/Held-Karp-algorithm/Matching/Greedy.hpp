@@ -0,0 +1,37 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "../ADS/CompleteGraph.hpp"
+
+using namespace std;
+
+namespace Matching
+{
+	/*
+	Approximate minimum weight perfect matching on the complete graph of a vertex subset:
+	greedy over k candidate neighbours of each vertex, then 2-opt exchanges between matched pairs.
+	O(V·k ㏒ V) on given candidates, O(V²) when the k nearest have to be found by scanning.
+	No guarantee on the weight, used for throughput on large instances.
+	*/
+	class Greedy
+	{
+	private:
+		const unsigned short k;
+
+	public:
+		Greedy(unsigned short neighbours = 10);
+
+		// pairs of vertices of the matrix behind G; G must have an even number of nodes.
+		// candidates, if any, lists neighbours of each node of G, otherwise its k nearest are used
+		vector<pair<unsigned short, unsigned short>> Solve(const ADS::CompleteGraph &G, const vector<vector<unsigned short>> *candidates = nullptr);
+
+	};
+}
\ No newline at end of file
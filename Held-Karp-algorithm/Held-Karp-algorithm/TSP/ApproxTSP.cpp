@@ -12,16 +12,25 @@ The problem can be described as: find a tour of N cities in a country (assuming
 */
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <stack>
 
 #include "ApproxTSP.hpp"
-#include "../ADS/Graph.hpp"
+#include "LocalSearch.hpp"
+#include "../ADS/CompleteGraph.hpp"
 #include "../MST/Prim.hpp"
 
 namespace TSP
 {
 	ApproxTSP::ApproxTSP(const vector<vector<float>> &DistanceMatrix2D) : TSP(DistanceMatrix2D) {}
 
+	void ApproxTSP::SetLocalSearch(bool enabled, float seconds)
+	{
+		localSearch = enabled;
+		localSearchSeconds = seconds;
+	}
+
 	/*
 	Algo. from: Cormen, T. and Leiserson, C. and Rivest, R. and Stein, C., 2010. Introduzione agli algoritmi e strutture dati. McGraw-Hill.
 	Algo.:
@@ -32,24 +41,66 @@ namespace TSP
 	04		return il ciclo hamiltoniano H
 	05	end function
 	*/
-	void ApproxTSP::Solve(float &opt, string &path) // Θ(V²)
+	void ApproxTSP::PreVisit(const vector<unsigned short> &π, stack<size_t> &H, unsigned short r) // O(V)
+	{
+		// children lists in CSR form, filled in ascending id
+		vector<size_t> first(numberOfNodes + 1, 0);
+		vector<unsigned short> child(numberOfNodes);
+
+		for (unsigned short v = 0; v < numberOfNodes; v++)
+			if (π[v] != UINT16_MAX)
+				first[π[v] + 1]++;
+
+		for (unsigned short u = 0; u < numberOfNodes; u++)
+			first[u + 1] += first[u];
+
+		vector<size_t> next(first.begin(), first.end() - 1);
+
+		for (unsigned short v = 0; v < numberOfNodes; v++)
+			if (π[v] != UINT16_MAX)
+				child[next[π[v]]++] = v;
+
+		// explicit recursion stack: node and index of its next child to visit
+		stack<pair<unsigned short, size_t>> S;
+
+		H.push(r);
+		S.emplace(r, first[r]);
+
+		while (!S.empty())
+		{
+			auto &top = S.top();
+
+			if (top.second == first[top.first + 1])
+			{
+				S.pop();
+			}
+			else
+			{
+				auto v = child[top.second++];
+
+				H.push(v);
+				S.emplace(v, first[v]);
+			}
+		}
+	}
+
+	void ApproxTSP::SolveTour(float &opt, vector<unsigned short> &circuit) // Θ(V²)
 	{
-		maxCardinality = 4;
+		maxCardinality = (localSearch ? 5 : 4);
 
-		Graph G(numberOfNodes);
-		G.MakeConnected(distance);
+		CompleteGraph G(distance);
 		currentCardinality++;
 
 		MST::Prim prim;
-		prim.Solve(distance, G, 0); // O(E ㏒ V)
+		auto π = prim.Solve(G, 0); // O(V²)
 		currentCardinality++;
 
 		stack<size_t> H;
-		G.PreVisit(H, 0); // O(V)
+		PreVisit(π, H, 0); // O(V)
 		currentCardinality++;
 
 		opt = 0;
-		path = "0 ";
+		circuit.assign(1, 0);
 
 		size_t u = 0;
 		while (!H.empty()) // O(V)
@@ -58,10 +109,33 @@ namespace TSP
 			H.pop();
 
 			opt += distance[u][v];
-			path += to_string(v) + " ";
+			circuit.push_back(v);
 
 			u = v;
 		}
 		currentCardinality++;
+
+		if (localSearch)
+		{
+			circuit.pop_back();
+
+			opt = ImproveTour(distance, circuit, localSearchSeconds); // O(V·k) per pass
+
+			rotate(circuit.begin(), find(circuit.begin(), circuit.end(), 0), circuit.end());
+			circuit.push_back(0);
+
+			currentCardinality++;
+		}
+	}
+
+	void ApproxTSP::Solve(float &opt, string &path)
+	{
+		vector<unsigned short> circuit;
+		SolveTour(opt, circuit);
+
+		path = "";
+
+		for (auto const v : circuit)
+			path += to_string(v) + " ";
 	}
 }
\ No newline at end of file
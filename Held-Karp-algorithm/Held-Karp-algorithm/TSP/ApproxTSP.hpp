@@ -6,6 +6,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 #pragma once
 
+#include <stack>
 #include <vector>
 
 #include "Base/TSP.hpp"
@@ -16,11 +17,23 @@ namespace TSP
 {
 	class ApproxTSP : public Base::TSP
 	{
+	private:
+		// 2-opt and Or-opt on the final tour, or iterated Lin–Kernighan for localSearchSeconds
+		bool localSearch = false;
+		float localSearchSeconds = 0;
+
+		// preorder walk of the tree given by the parent vector π, children in ascending id
+		void PreVisit(const vector<unsigned short> &π, stack<size_t> &H, unsigned short r);
+
 	protected:
 		void Solve(float &opt, string &path);
 
 	public:
 		ApproxTSP(const vector<vector<float>> &DistanceMatrix2D);
 
+		void SetLocalSearch(bool enabled, float seconds = 0);
+
+		void SolveTour(float &opt, vector<unsigned short> &circuit);
+
 	};
 }
\ No newline at end of file
@@ -6,70 +6,38 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 #pragma once
 
-#include "Kruskal.hpp"
+#include "AscentTrace.hpp"
 
-namespace MST
+namespace TSP
 {
-
-	void Kruskal::MakeSet(shared_ptr<Node> x)
-	{
-		x->π = x;
-		x->rank = 0;
-	}
-
-	shared_ptr<Node> Kruskal::FindSet(shared_ptr<Node> x)
+	AscentTrace::AscentTrace(const string &fileName) :
+		out(fileName),
+		begin(steady_clock::now()),
+		ascents(0)
 	{
-		if (x->π->id != x->id)
-			x->π = FindSet(x->π);
-
-		return x->π;
+		out << "source,ascent,iteration,bound,step,norm,violations,us" << endl;
 	}
 
-	void Kruskal::Link(shared_ptr<Node> x, shared_ptr<Node> y)
+	size_t AscentTrace::NewAscent()
 	{
-		if (x->rank > y->rank)
-		{
-			y->π = x;
-		}
-		else
-		{
-			x->π = y;
-
-			if (x->rank == y->rank)
-				y->rank++;
-		}
+		return ascents++;
 	}
 
-	void Kruskal::Union(shared_ptr<Node> x, shared_ptr<Node> y)
+	void AscentTrace::Record(const char *source, size_t ascent, unsigned short iteration, float bound, float step, float norm, unsigned short violations)
 	{
-		auto u = FindSet(x);
-		auto v = FindSet(y);
-
-		Link(u, v);
-	}
-
-	shared_ptr<Graph> Kruskal::Solve(Graph &G) // O(E ㏒ V)
-	{
-		Graph T(G.V);
-
-		for (auto v : G.V)
-			MakeSet(v);
-
-		G.SortEdgeByWeight();
-
-		for (auto e : G.E)
-		{
-			auto u = e->from;
-			auto v = e->to;
-
-			if (FindSet(u) != FindSet(v))
-			{
-				T.E.push_back(e);
-				Union(u, v);
-			}
-		}
-
-		return make_shared<Graph>(T);
+		auto us = duration_cast<microseconds>(steady_clock::now() - begin).count();
+
+		lock_guard<mutex> guard(lock);
+
+		out
+			<< source << ","
+			<< ascent << ","
+			<< iteration << ","
+			<< bound << ","
+			<< step << ","
+			<< norm << ","
+			<< violations << ","
+			<< us << "\n";
 	}
 
 }
\ No newline at end of file
@@ -6,27 +6,33 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 #pragma once
 
-#include <list>
-#include <memory>
-#include <vector>
-
-#include "../ADS/Graph.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
 
 using namespace std;
-using namespace ADS;
+using namespace chrono;
 
-namespace MST
+namespace TSP
 {
-	class Kruskal
+	// CSV of the subgradient iterations: one line per iteration of every ascent, shared by the threads
+	class AscentTrace
 	{
 	private:
-		shared_ptr<Node> FindSet(shared_ptr<Node> x);
-		void MakeSet(shared_ptr<Node> x);
-		void Link(shared_ptr<Node> x, shared_ptr<Node> y);
-		void Union(shared_ptr<Node> x, shared_ptr<Node> y);
+		mutex lock;
+		ofstream out;
+		time_point<steady_clock> begin;
+		atomic<size_t> ascents;
 
 	public:
-		shared_ptr<Graph> Solve(Graph &G);
+		AscentTrace(const string &fileName);
+
+		// id of a new ascent, to tell apart the lines of concurrent ascents
+		size_t NewAscent();
+
+		void Record(const char *source, size_t ascent, unsigned short iteration, float bound, float step, float norm, unsigned short violations);
 
 	};
 }
\ No newline at end of file
@@ -110,6 +110,11 @@ namespace TSP
 			return A;
 		}
 
+		string TSP::Report()
+		{
+			return "";
+		}
+
 		void TSP::SilentSolve(float &opt, string &path)
 		{
 			Solve(opt, path);
@@ -142,6 +147,7 @@ namespace TSP
 					<< duration_cast<milliseconds>(system_clock::now() - begin).count()
 					<< "ms, path: "
 					<< path
+					<< Report()
 					<< endl;
 			}
 			catch (const exception &e)
@@ -44,13 +44,16 @@ namespace TSP
 			unsigned int Powered2Code(const unsigned int code, const unsigned short exclude);
 
 			void ETL();
-			void ETLw();
+			virtual void ETLw();
 
 			template <class T>
 			static T generateRandomNumber(const T startRange, const T endRange, const T limit);
 
 			virtual void Solve(float &opt, string &path) = 0;
 
+			// extra results printed by Run after the path
+			virtual string Report();
+
 		public:
 			TSP(const vector<vector<float>> &DistanceMatrix2D);
 
@@ -0,0 +1,135 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+namespace TSP
+{
+	/*
+	Fixed-width little-endian fields, byte by byte: the same file on every compiler and architecture.
+	Floats are written as their IEEE 754 binary32 bits.
+	*/
+	class BinaryWriter
+	{
+	private:
+		ostream &out;
+
+		void Bytes(uint64_t v, unsigned short size)
+		{
+			char b[8];
+
+			for (unsigned short k = 0; k < size; k++)
+				b[k] = static_cast<char>((v >> (8 * k)) & 0xFF);
+
+			out.write(b, size);
+		}
+
+	public:
+		BinaryWriter(ostream &out) : out(out) {}
+
+		void Raw(const char *p, size_t size)
+		{
+			out.write(p, size);
+		}
+
+		void U8(uint8_t v) { Bytes(v, 1); }
+		void U16(uint16_t v) { Bytes(v, 2); }
+		void U32(uint32_t v) { Bytes(v, 4); }
+		void U64(uint64_t v) { Bytes(v, 8); }
+		void I64(int64_t v) { Bytes(static_cast<uint64_t>(v), 8); }
+
+		void F32(float v)
+		{
+			uint32_t bits;
+			memcpy(&bits, &v, sizeof(bits));
+
+			Bytes(bits, 4);
+		}
+	};
+
+	// reads what BinaryWriter wrote; past the end of the stream every field is 0 and the stream is failed
+	class BinaryReader
+	{
+	private:
+		istream &in;
+
+		uint64_t Bytes(unsigned short size)
+		{
+			unsigned char b[8] = { 0 };
+			uint64_t v = 0;
+
+			in.read(reinterpret_cast<char*>(b), size);
+
+			for (unsigned short k = 0; k < size; k++)
+				v |= uint64_t(b[k]) << (8 * k);
+
+			return v;
+		}
+
+	public:
+		BinaryReader(istream &in) : in(in) {}
+
+		bool Good() const
+		{
+			return !in.fail();
+		}
+
+		void Raw(char *p, size_t size)
+		{
+			in.read(p, size);
+		}
+
+		uint8_t U8() { return static_cast<uint8_t>(Bytes(1)); }
+		uint16_t U16() { return static_cast<uint16_t>(Bytes(2)); }
+		uint32_t U32() { return static_cast<uint32_t>(Bytes(4)); }
+		uint64_t U64() { return Bytes(8); }
+		int64_t I64() { return static_cast<int64_t>(Bytes(8)); }
+
+		// bytes after the read position, 0 on a failed stream
+		uint64_t Left()
+		{
+			if (in.fail())
+				return 0;
+
+			auto at = in.tellg();
+			in.seekg(0, ios::end);
+			auto end = in.tellg();
+			in.seekg(at);
+
+			return (in.fail() ? 0 : static_cast<uint64_t>(end - at));
+		}
+
+		// number of the records of size bytes that follow; a count the rest of the stream cannot hold gives 0 and fails it
+		uint64_t Count(size_t size)
+		{
+			auto count = U64();
+
+			if (count > Left() / size)
+			{
+				in.setstate(ios::failbit);
+				return 0;
+			}
+
+			return count;
+		}
+
+		float F32()
+		{
+			auto bits = U32();
+			float v;
+
+			memcpy(&v, &bits, sizeof(v));
+
+			return v;
+		}
+	};
+}
\ No newline at end of file
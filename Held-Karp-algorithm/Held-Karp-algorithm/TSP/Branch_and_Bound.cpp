@@ -13,14 +13,77 @@ The problem can be described as: find a tour of N cities in a country (assuming
 #pragma once
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <future>
 #include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
 
 #include "Branch_and_Bound.hpp"
+#include "ApproxTSP.hpp"
+#include "Christofides.hpp"
+#include "HeldKarp.hpp"
+#include "LocalSearch.hpp"
+#include "BinaryIO.hpp"
 #include "../MST/Prim.hpp"
 
 namespace TSP
 {
-	Branch_and_Bound::Branch_and_Bound(const vector<vector<float>> &DistanceMatrix2D) : TSP(DistanceMatrix2D) {}
+	Branch_and_Bound::Branch_and_Bound(const vector<vector<float>> &DistanceMatrix2D, unsigned short threads, WarmStart warmStart) :
+		TSP(DistanceMatrix2D),
+		numberOfThreads(threads > 0 ? threads : max(1u, thread::hardware_concurrency())),
+		warmStart(warmStart),
+		UB(FLT_MAX),
+		pendingNodes(0),
+		queuedNodes(0),
+		checkpointPending(false) {}
+
+	void Branch_and_Bound::SetStatisticsFile(const string &fileName)
+	{
+		statisticsFile = fileName;
+	}
+
+	Statistics &Branch_and_Bound::GetStatistics()
+	{
+		return statistics;
+	}
+
+	void Branch_and_Bound::SetTrace(AscentTrace *trace)
+	{
+		this->trace = trace;
+	}
+
+	void Branch_and_Bound::SetFinish(unsigned short nodes)
+	{
+		finishNodes = nodes;
+	}
+
+	void Branch_and_Bound::SetCheckpoint(const string &fileName, unsigned int interval)
+	{
+		checkpointFile = fileName;
+		checkpointInterval = max(1u, interval);
+	}
+
+	void Branch_and_Bound::ETLw()
+	{
+		while (writingBuffer)
+			this_thread::sleep_for(milliseconds(100));
+
+		writingBuffer = true;
+
+		cout << statistics.Line() + "\r";
+		fflush(stdin);
+
+		writingBuffer = false;
+	}
 
 	string Branch_and_Bound::PrintPath(vector<sEdge> &path)
 	{
@@ -53,7 +116,19 @@ namespace TSP
 		return s + "0";
 	}
 
-	vector<sNode> Branch_and_Bound::Branch(sTree &T, vector<unsigned short> &δ, sNode &current_node, unsigned short n)
+	// Constrain edge e of a child, only if its parent has it free; a contradiction makes the child infeasible
+	void Branch_and_Bound::Constrain(const sConstraint *&child, bool &feasible, sConstraintState &S, sEdge e, Constraints c)
+	{
+		auto old = S.State(e.from, e.to);
+
+		if (old == Free)
+			child = arena.Add(child, e, c);
+		else if (old != c)
+			feasible = false;
+	}
+
+	// S holds the constraints of current_node
+	vector<sNode> Branch_and_Bound::Branch(sTree &T, vector<unsigned short> &δ, sNode &current_node, sConstraintState &S, unsigned short n)
 	{
 		vector<sNode> result;
 		auto min_δ_req = n;
@@ -64,7 +139,8 @@ namespace TSP
 
 		for (unsigned short i = 0; i < n; i++)
 			if (δ[i] > 2)
-				if (current_node.IncidentToRequired(i, n) == n)
+			{
+				if (S.IncidentToRequired(i) == n)
 				{
 					if (δ[i] < min_δ)
 					{
@@ -78,9 +154,10 @@ namespace TSP
 					{
 						min_δ_req = δ[i];
 						p_req = i;
-						req_neighbor = current_node.IncidentToRequired(i, n);
+						req_neighbor = S.IncidentToRequired(i);
 					}
 				}
+			}
 
 		if (min_δ_req < n)
 		{
@@ -88,218 +165,286 @@ namespace TSP
 
 			for (i = 0; i < n; i++)
 				if (i != p_req && i != req_neighbor)
-					if (!T.Contains(i, p_req) && !current_node.Forbidden(i, p_req))
+					if (!T.Contains(i, p_req) && S.State(i, p_req) == Free)
 						break;
 
 			if (i == n)
 				for (i = 0; i < n; i++)
 					if (i != p_req && i != req_neighbor)
-						if (!current_node.Forbidden(i, p_req))
+						if (S.State(i, p_req) == Free)
 							break;
 
-			auto F = current_node.F;
-			auto R = current_node.R;
-			R.push_back(sEdge(i, p_req));
+			auto feasible = true;
+			auto C = current_node.constraints;
+			Constrain(C, feasible, S, sEdge(i, p_req), Forced);
 
 			for (unsigned short k = 0; k < n; k++)
-				if (k != i && k != p_req && k != req_neighbor && !current_node.Forbidden(p_req, k))
-					F.push_back(sEdge(p_req, k));
+				if (k != i && k != p_req && k != req_neighbor && !S.Forbidden(p_req, k))
+					Constrain(C, feasible, S, sEdge(p_req, k), Forbidden);
 
-			sNode S2(R, F, current_node.λ, n);
-			result.push_back(S2);
+			if (feasible)
+				result.push_back(sNode(C, current_node.λ));
 
-			R = current_node.R;
-			F = current_node.F;
-			F.push_back(sEdge(i, p_req));
+			feasible = true;
+			C = current_node.constraints;
+			Constrain(C, feasible, S, sEdge(i, p_req), Forbidden);
 
 			vector<unsigned short> forbidden(n, 0);
 			forbidden[p_req] = 1;
+			forbidden[i] = 1;
 
-			auto num_forbidden = CountElements(F, forbidden, p_req);
+			auto num_forbidden = CountElements(S, forbidden, p_req) + 1;
 
 			if (num_forbidden == n - 3)
 				for (unsigned short k = 0; k < n; k++)
 					if (!forbidden[k])
 						if (k != req_neighbor)
-							R.push_back(sEdge(p_req, k));
+							Constrain(C, feasible, S, sEdge(p_req, k), Forced);
 
-			sNode S3(R, F, current_node.λ, n);
-			result.push_back(S3);
+			if (feasible)
+				result.push_back(sNode(C, current_node.λ));
 		}
 		else
 		{
 			unsigned short i, j;
 
 			for (i = 0; i < n; i++)
-				if (i != p && !T.Contains(i, p) && !current_node.Forbidden(i, p))
+				if (i != p && !T.Contains(i, p) && !S.Forbidden(i, p))
 					break;
 
 			if (i == n)
 				for (i = 0; i < n; i++)
-					if (i != p && !current_node.Forbidden(i, p))
+					if (i != p && !S.Forbidden(i, p))
 						break;
 
 			for (j = 0; j < n; j++)
 				if (j != p && j != i)
-					if (!current_node.Forbidden(j, p))
+					if (!S.Forbidden(j, p))
 						break;
 
-			auto F = current_node.F;
-			auto R = current_node.R;
-			R.push_back(sEdge(i, p));
-			R.push_back(sEdge(j, p));
+			auto feasible = true;
+			auto C = current_node.constraints;
+			Constrain(C, feasible, S, sEdge(i, p), Forced);
+			Constrain(C, feasible, S, sEdge(j, p), Forced);
 
 			for (unsigned short k = 0; k < n; k++)
-				if (k != i && k != p && k != j && !current_node.Forbidden(p, k))
-					F.push_back(sEdge(p, k));
+				if (k != i && k != p && k != j && !S.Forbidden(p, k))
+					Constrain(C, feasible, S, sEdge(p, k), Forbidden);
 
-			sNode S1(R, F, current_node.λ, n);
-			result.push_back(S1);
+			if (feasible)
+				result.push_back(sNode(C, current_node.λ));
 
-			R = current_node.R;
-			F = current_node.F;
-			R.push_back(sEdge(i, p));
-			F.push_back(sEdge(j, p));
+			feasible = true;
+			C = current_node.constraints;
+			Constrain(C, feasible, S, sEdge(i, p), Forced);
+			Constrain(C, feasible, S, sEdge(j, p), Forbidden);
 
 			vector<unsigned short> forbidden(n, 0);
 			forbidden[p] = 1;
+			forbidden[j] = 1;
 
-			auto num_forbidden = CountElements(F, forbidden, p);
+			auto num_forbidden = CountElements(S, forbidden, p) + 1;
 
 			if (num_forbidden == n - 3)
 				for (unsigned short k = 0; k < n; k++)
 					if (!forbidden[k])
 						if (k != i)
-							R.push_back(sEdge(p, k));
+							Constrain(C, feasible, S, sEdge(p, k), Forced);
 
-			sNode S2(R, F, current_node.λ, n);
-			result.push_back(S2);
+			if (feasible)
+				result.push_back(sNode(C, current_node.λ));
 
-			R = current_node.R;
-			F = current_node.F;
-			F.push_back(sEdge(i, p));
+			feasible = true;
+			C = current_node.constraints;
+			Constrain(C, feasible, S, sEdge(i, p), Forbidden);
 
 			if (num_forbidden == n - 3)
 			{
 				for (unsigned short k = 0; k < n; k++)
 					if (!forbidden[k])
 						if (k != i)
-							R.push_back(sEdge(p, k));
+							Constrain(C, feasible, S, sEdge(p, k), Forced);
 
-				R.push_back(sEdge(p, j));
+				Constrain(C, feasible, S, sEdge(p, j), Forced);
 			}
 
-			sNode S3(R, F, current_node.λ, n);
-			result.push_back(S3);
+			if (feasible)
+				result.push_back(sNode(C, current_node.λ));
 		}
 
 		return result;
 	}
 
-	bool Branch_and_Bound::Bound(sNode &node, vector<unsigned short> &δ, float t, unsigned short const steps)
+	// Counts the required edges at 0 (req1, req2) and elsewhere (req); true if a node has three of them
+	bool Branch_and_Bound::Required(const sConstraint *constraints, const sConstraintState &S, unsigned short &req1, unsigned short &req2, unsigned short &req)
 	{
-		MST::Prim prim;
+		req1 = req2 = req = 0;
 
-		vector<vector<float>> w(numberOfNodes, vector<float>(numberOfNodes));
-		vector<vector<unsigned short>> omitted(numberOfNodes, vector<unsigned short>(numberOfNodes, 0));
-		vector<float> Λ(numberOfNodes);
-		vector<bool> forbidden(numberOfNodes, 0);
-		sTree T(numberOfNodes);
+		for (auto c = constraints; c != nullptr; c = c->parent)
+			if (c->type == Forced)
+			{
+				auto e = c->edge;
 
-		float W = 0;
+				// no tour has three required edges at a node
+				if (S.requiredDegree[e.from] > 2 || S.requiredDegree[e.to] > 2)
+					return true;
 
-		float Δ = 3.0f * t / (2.0f * steps);
-		float dΔ = t / (steps * steps - steps);
+				if (e.from == 0 || e.to == 0)
+				{
+					auto v = (e.from == 0 ? e.to : e.from);
+
+					if (req1 == 0)
+						req1 = v;
+					else
+						req2 = v;
+				}
+				else
+				{
+					req++;
+				}
+			}
+
+		return false;
+	}
+
+	// 1-tree of the constraints loaded in BW.S on w[i][j] = distance[i][j] + λ[i] + λ[j] into BW.T; true if there is none
+	bool Branch_and_Bound::OneTree(sBoundWorkspace &BW, const vector<float> &λ, unsigned short req1, unsigned short req2, unsigned short req)
+	{
+		MST::Prim prim;
+
+		auto &S = BW.S;
+		auto &T = BW.T;
+
+		// w is never materialised
+		if (prim.Solve(T, BW.prim, distance, λ, S, req, candidates.empty() ? nullptr : &candidates))
+			return true;
 
 		float min1 = FLT_MAX;
 		float min2 = FLT_MAX;
 
-		unsigned short id1, id2;
+		// the cheapest free edges of node 0 besides a required one
+		unsigned short id1 = UINT16_MAX, id2 = UINT16_MAX;
 
-		unsigned short req1 = 0;
-		unsigned short req2 = 0;
-		unsigned short req = node.R.size();
+		for (unsigned short i = 1; i < numberOfNodes; i++)
+			if (i != req1 && distance[0][i] + λ[0] + λ[i] < min1 && !S.Forbidden(0, i))
+			{
+				min1 = distance[0][i] + λ[0] + λ[i];
+				id1 = i;
+			}
 
-		for (unsigned short i = 0; i < numberOfNodes; i++)
-			δ[i] = 0;
+		for (unsigned short i = 1; i < numberOfNodes; i++)
+			if (i != id1)
+				if (distance[0][i] + λ[0] + λ[i] < min2 && !S.Forbidden(0, i))
+				{
+					min2 = distance[0][i] + λ[0] + λ[i];
+					id2 = i;
+				}
 
-		for (unsigned short i = 0; i < node.R.size(); i++)
+		// node 0 has fewer free edges than it lacks
+		if ((req1 == 0 && id2 == UINT16_MAX) || (req2 == 0 && id1 == UINT16_MAX))
+			return true;
+
+		if (req1 == 0)
+		{
+			T[T.size() - 2] = sEdge(0, id1);
+			T[T.size() - 1] = sEdge(0, id2);
+		}
+		else if (req2 == 0)
 		{
-			omitted[node.R[i].from][node.R[i].to] = 1;
-			omitted[node.R[i].to][node.R[i].from] = 1;
+			T[T.size() - 2] = sEdge(0, id1);
+			T[T.size() - 1] = sEdge(0, req1);
+		}
+		else
+		{
+			T[T.size() - 2] = sEdge(0, req1);
+			T[T.size() - 1] = sEdge(0, req2);
+		}
 
-			if (node.R[i].from == 0)
-			{
-				req--;
+		return false;
+	}
 
-				if (req < node.R.size() - 1)
-					req2 = node.R[i].to;
-				else
-					req1 = node.R[i].to;
-			}
+	/*
+	The 1-tree of an open node into BW.T and its degrees into δ, from its multipliers and the constraints loaded in BW.S:
+	the same tree its ascent found best, at the cost of a single Prim. True if the constraints admit no 1-tree.
+	*/
+	bool Branch_and_Bound::Rebuild(const sNode &node, sBoundWorkspace &BW, vector<unsigned short> &δ)
+	{
+		unsigned short req1, req2, req;
 
-			if (node.R[i].to == 0)
-			{
-				req--;
+		if (Required(node.constraints, BW.S, req1, req2, req) || OneTree(BW, *node.λ, req1, req2, req))
+			return true;
 
-				if (req < node.R.size() - 1)
-					req2 = node.R[i].from;
-				else
-					req1 = node.R[i].from;
-			}
+		for (unsigned short i = 0; i < numberOfNodes; i++)
+		{
+			δ[BW.T[i].from]++;
+			δ[BW.T[i].to]++;
 		}
 
-		for (unsigned short i = 0; i < node.F.size(); i++)
-		{
-			omitted[node.F[i].from][node.F[i].to] = 2;
-			omitted[node.F[i].to][node.F[i].from] = 2;
+		return false;
+	}
 
-			if (node.F[i].from == 0)
-				forbidden[node.F[i].to] = 1;
+	/*
+	Subgradient ascent on the 1-tree of node, from its multipliers; true if node is infeasible or cannot beat UB.
+	Otherwise the best 1-tree is left in BW.best, its degrees in δ, and node.λ holds its multipliers.
+	*/
+	bool Branch_and_Bound::Bound(sNode &node, sBoundWorkspace &BW, vector<unsigned short> &δ, float t, unsigned short const steps)
+	{
+		auto &S = BW.S;
+		auto &T = BW.T;
+		auto &Λ = BW.Λ;
+		auto &λ = BW.λ;
 
-			if (node.F[i].to == 0)
-				forbidden[node.F[i].from] = 1;
-		}
+		λ = *node.λ;
+
+		float W = 0;
+
+		float Δ = 3.0f * t / (2.0f * steps);
+		float dΔ = t / (steps * steps - steps);
+
+		// the ascent stops when the bound does not rise for this many steps
+		const unsigned short patience = max<unsigned short>(steps / 4, 20);
+		unsigned short stagnation = 0;
+		unsigned short violations;
+
+		unsigned short req1, req2, req;
+
+		// the best 1-tree came after the first step: the multipliers of the parent are no longer those of node
+		auto moved = false;
 
 		for (unsigned short i = 0; i < numberOfNodes; i++)
-			for (unsigned short j = 0; j < numberOfNodes; j++)
-				w[i][j] = (i == j ? FLT_MAX : distance[i][j] + node.λ[i] + node.λ[j]);
+			δ[i] = 0;
+
+		unsigned short k = 0;
+		long long primTime = 0;
 
-		for (unsigned short k = 0; k < steps; k++)
+		const auto ascent = (trace ? trace->NewAscent() : 0);
+
+		// every exit of the ascent is accounted
+		auto finish = [&](bool pruned)
 		{
-			if (prim.Solve(T, omitted, w, req, numberOfNodes))
-				return true;
+			statistics.Ascent(k);
+			statistics.primNanoseconds += primTime;
 
-			for (unsigned short i = 1; i < numberOfNodes; i++)
-				if (w[0][i] < min1 && !forbidden[i])
-				{
-					min1 = w[0][i];
-					id1 = i;
-				}
+			S.Unload(node.constraints);
 
-			for (unsigned short i = 1; i < numberOfNodes; i++)
-				if (i != id1)
-					if (w[0][i] < min2 && !forbidden[i])
-					{
-						min2 = w[0][i];
-						id2 = i;
-					}
+			return pruned;
+		};
 
-			if (req1 == 0)
-			{
-				T[T.size() - 2] = sEdge(0, id1);
-				T[T.size() - 1] = sEdge(0, id2);
-			}
-			else if (req2 == 0)
-			{
-				T[T.size() - 2] = sEdge(0, id1);
-				T[T.size() - 1] = sEdge(0, req1);
-			}
-			else
-			{
-				T[T.size() - 2] = sEdge(0, req1);
-				T[T.size() - 1] = sEdge(0, req2);
-			}
+		S.Load(node.constraints);
+
+		if (Required(node.constraints, S, req1, req2, req))
+			return finish(true);
+
+		for (; k < steps; k++)
+		{
+			auto p0 = steady_clock::now();
+
+			auto infeasible = OneTree(BW, λ, req1, req2, req);
+
+			primTime += duration_cast<nanoseconds>(steady_clock::now() - p0).count();
+
+			if (infeasible)
+				return finish(true);
 
 			for (unsigned short i = 0; i < T.size(); i++)
 			{
@@ -309,46 +454,65 @@ namespace TSP
 
 			for (unsigned short i = 0; i < T.size(); i++)
 			{
-				W += w[T[i].from][T[i].to];
-				W -= 2 * node.λ[i];
+				W += distance[T[i].from][T[i].to] + λ[T[i].from] + λ[T[i].to];
+				W -= 2 * λ[i];
 			}
 
 			if (node.bound < W)
 			{
 				node.bound = W;
+				stagnation = 0;
+				moved = (k > 0);
 
-				for (unsigned short i = 0; i < node.oneTree.size(); i++)
-				{
-					node.oneTree[i] = T[i];
-					Λ[i] = node.λ[i];
-				}
+				BW.best.T = T.T;
+				Λ = λ;
+
+				// dominated by the incumbent: the child would be discarded anyway
+				if (Dominated(node.bound))
+					return finish(true);
+			}
+			else
+			{
+				stagnation++;
 			}
 
-			for (unsigned short i = 0; i < numberOfNodes; i++)
-				for (unsigned short j = 0; j < numberOfNodes; j++)
-					if (i != j)
-						w[i][j] += (δ[i] - 2) * t + (δ[j] - 2) * t;
+			violations = 0;
+			float norm = 0;
 
 			for (unsigned short i = 0; i < numberOfNodes; i++)
 			{
-				node.λ[i] += (δ[i] - 2) * t;
+				if (δ[i] != 2)
+					violations++;
+
+				norm += (δ[i] - 2) * (δ[i] - 2);
+				λ[i] += (δ[i] - 2) * t;
 				δ[i] = 0;
 			}
 
+			if (trace)
+				trace->Record("BB", ascent, k, W, t, sqrt(norm), violations);
+
+			// the 1-tree is a tour, or the ascent has converged
+			if (violations == 0 || stagnation >= patience)
+			{
+				k++;
+				break;
+			}
+
 			t -= Δ;
 			Δ -= dΔ;
 			W = 0;
-
-			min1 = FLT_MAX;
-			min2 = FLT_MAX;
 		}
 
+		finish(false);
+
+		if (moved)
+			node.λ = make_shared<const vector<float>>(Λ);
+
 		for (unsigned short i = 0; i < numberOfNodes; i++)
 		{
-			node.λ[i] = Λ[i];
-
-			δ[node.oneTree[i].from]++;
-			δ[node.oneTree[i].to]++;
+			δ[BW.best[i].from]++;
+			δ[BW.best[i].to]++;
 		}
 
 		return false;
@@ -358,14 +522,15 @@ namespace TSP
 	float Branch_and_Bound::t1()
 	{
 		float t = 0;
-		unsigned short id1, id2;
+		unsigned short id1 = UINT16_MAX, id2 = UINT16_MAX;
 
-		sTree T(numberOfNodes);
-		vector<vector<unsigned short>> omitted(numberOfNodes, vector<unsigned short>(numberOfNodes, 0));
+		sBoundWorkspace BW(numberOfNodes);
+		vector<float> λ(numberOfNodes, 0);
 
 		MST::Prim prim;
-		prim.Solve(T, omitted, distance, 0, numberOfNodes);
+		prim.Solve(BW.T, BW.prim, distance, λ, BW.S, 0);
 
+		auto &T = BW.T;
 		T.GetMin0Nodes(distance, id1, id2);
 
 		T[T.size() - 2] = sEdge(0, id1);
@@ -377,125 +542,871 @@ namespace TSP
 		return t / (2.0f * numberOfNodes);
 	}
 
-	// Add to priority queue
+	// Tour of the warm start heuristic improved by 2-opt
+	vector<unsigned short> Branch_and_Bound::Heuristic()
+	{
+		float cost;
+		vector<unsigned short> circuit;
+
+		if (warmStart == WarmStart::ApproxTSP)
+		{
+			ApproxTSP approxTSP(distance);
+			approxTSP.SolveTour(cost, circuit);
+		}
+		else
+		{
+			Christofides christofides(distance);
+			christofides.SolveTour(cost, circuit);
+		}
+
+		// drop the return to the first node
+		circuit.pop_back();
+
+		LocalSearch<> localSearch(distance);
+		localSearch.LinKernighan(circuit, 0);
+
+		return circuit;
+	}
+
+	/*
+	Reduced-cost elimination: forcing the non-tree edge (i, j) into the 1-tree of the root costs at least
+	w[i][j] minus the most expensive edge on the tree path i..j (minus the dearest edge at 0 when i = 0).
+	An edge that lifts the bound of the root to UB cannot be in a better tour and is forbidden everywhere.
+	Return false if a node is left with less than two edges: no tour beats UB.
+	*/
+	bool Branch_and_Bound::EliminateEdges(const sNode &root, const sTree &T) // O(V²)
+	{
+		const auto n = numberOfNodes;
+		const auto &λ = *root.λ;
+
+		auto w = [&](unsigned short i, unsigned short j)
+		{
+			return distance[i][j] + λ[i] + λ[j];
+		};
+
+		eliminated.assign(n * n, Free);
+		candidates.assign(n, vector<unsigned short>());
+
+		float max0 = 0;
+		vector<vector<unsigned short>> adj(n);
+
+		for (unsigned short i = 0; i < n; i++)
+		{
+			auto e = T[i];
+
+			if (e.from == 0 || e.to == 0)
+			{
+				max0 = max(max0, w(e.from, e.to));
+			}
+			else
+			{
+				adj[e.from].push_back(e.to);
+				adj[e.to].push_back(e.from);
+			}
+		}
+
+		for (unsigned short j = 1; j < n; j++)
+			if (root.bound + w(0, j) - max0 >= UB)
+			{
+				eliminated[j] = Forbidden;
+				eliminated[j * n] = Forbidden;
+			}
+
+		vector<float> β(n);
+		vector<unsigned short> π(n), Q;
+
+		for (unsigned short r = 1; r < n; r++)
+		{
+			// β[v] is the most expensive edge on the tree path r..v
+			β[r] = -FLT_MAX;
+			π[r] = r;
+			Q.push_back(r);
+
+			while (!Q.empty())
+			{
+				auto u = Q.back();
+				Q.pop_back();
+
+				for (auto v : adj[u])
+					if (v != π[u])
+					{
+						π[v] = u;
+						β[v] = max(β[u], w(u, v));
+						Q.push_back(v);
+					}
+			}
+
+			for (unsigned short j = r + 1; j < n; j++)
+				if (root.bound + w(r, j) - β[j] >= UB)
+				{
+					eliminated[r * n + j] = Forbidden;
+					eliminated[j * n + r] = Forbidden;
+				}
+		}
+
+		for (unsigned short i = 0; i < n; i++)
+		{
+			for (unsigned short j = 0; j < n; j++)
+				if (i != j && eliminated[i * n + j] == Free)
+					candidates[i].push_back(j);
+
+			if (candidates[i].size() < 2)
+				return false;
+		}
+
+		return true;
+	}
+
+	// heap order of the open lists: the node of least bound on top
+	bool Branch_and_Bound::Dearer(const sNode &l, const sNode &r)
+	{
+		return l.bound > r.bound;
+	}
+
+	// no tour under bound beats UB by more than the rounding of the float costs
+	bool Branch_and_Bound::Dominated(float bound) const
+	{
+		return bound >= UB * (1 - ε);
+	}
+
+	// Add to priority queue, O(㏒ Q)
 	void Branch_and_Bound::PQ_Add(vector<sNode> &PQ, sNode &new_elem)
 	{
 		PQ.push_back(new_elem);
+		push_heap(PQ.begin(), PQ.end(), Dearer);
+	}
+
+	// the waiters check their condition under idleLock, so taking it here orders the change before the notification
+	void Branch_and_Bound::Wake(bool all)
+	{
+		lock_guard<mutex> guard(idleLock);
 
-		sort(PQ.begin(), PQ.end(), [](sNode &l, sNode &r) {
-			return l.bound > r.bound;
-		});
+		if (all)
+			idleSignal.notify_all();
+		else
+			idleSignal.notify_one();
 	}
 
-	void Branch_and_Bound::Solve(float &opt, string &path)
+	// Add to the open list of the worker
+	void Branch_and_Bound::Push(unsigned short worker, sNode &node)
 	{
-		vector<sEdge> tour(numberOfNodes);
+		statistics.OpenList(++pendingNodes);
 
-		// Upper bound on tour 0-1-2-.....-n
-		float UB = distance[numberOfNodes - 1][0];
-		tour[0] = sEdge(numberOfNodes - 1, 0);
+		{
+			lock_guard<mutex> guard(openLists[worker]->lock);
+			PQ_Add(openLists[worker]->Q, node);
+			queuedNodes++;
+		}
 
-		for (unsigned short i = 0; i < distance.size() - 1; i++)
+		Wake(false);
+	}
+
+	// Best node of the worker's own list, otherwise steal the best node of another worker
+	bool Branch_and_Bound::Pop(unsigned short worker, sNode &node)
+	{
+		for (unsigned short k = 0; k < numberOfThreads; k++)
 		{
-			UB += distance[i][i + 1];
-			tour[i + 1] = sEdge(i, i + 1);
+			auto L = openLists[(worker + k) % numberOfThreads].get();
+			lock_guard<mutex> guard(L->lock);
+
+			if (!L->Q.empty())
+			{
+				pop_heap(L->Q.begin(), L->Q.end(), Dearer);
+				node = move(L->Q.back());
+				L->Q.pop_back();
+				queuedNodes--;
+
+				// the best node of the list exceeds UB: all the others do
+				if (Dominated(node.bound))
+				{
+					statistics.nodesPruned += L->Q.size();
+					pendingNodes -= L->Q.size();
+					queuedNodes -= L->Q.size();
+					L->Q.clear();
+				}
+
+				return true;
+			}
 		}
 
+		return false;
+	}
 
-		auto t = t1();
-		unsigned short M = numberOfNodes * numberOfNodes / 50 + numberOfNodes + 15;
+	// T is a tour of the given cost
+	void Branch_and_Bound::UpdateIncumbent(float cost, const sTree &T)
+	{
+		lock_guard<mutex> guard(incumbentLock);
 
-		vector<sNode> Q;
+		statistics.nodesTour++;
 
-		// Calculate first Bound
+		if (cost < UB)
 		{
-			vector<unsigned short> δ(numberOfNodes, 0);
+			UB = cost;
+			statistics.Incumbent(cost);
 
-			sNode root(numberOfNodes);
-			Bound(root, δ, t, M);
+			for (unsigned short i = 0; i < numberOfNodes; i++)
+				tour[i] = T[i];
+		}
+	}
 
-			if (!root.oneTree.CheckTour())
+	/*
+	When the required edges leave at most finishNodes segment endpoints and free nodes, the subproblem S is solved exactly:
+	every path of required edges is contracted to its two endpoints, joined by a cheap edge;
+	the other edges cost M more and the forbidden ones 2kM more, so the HeldKarp optimum uses
+	every segment and no forbidden edge whenever such a tour exists.
+	Return true if the subproblem is closed, its optimum (if any) offered to the incumbent.
+	*/
+	bool Branch_and_Bound::Finish(sConstraintState &S)
+	{
+		const auto n = numberOfNodes;
+
+		vector<unsigned short> reduced, index(n, n), other(n, n);
+
+		for (unsigned short v = 0; v < n; v++)
+			if (S.requiredDegree[v] < 2)
 			{
-				for (unsigned short i = 0; i < numberOfNodes; i++)
-					tour[i] = root.oneTree[i];
+				index[v] = reduced.size();
+				reduced.push_back(v);
+			}
 
-				opt = root.bound;
-				path = PrintPath(tour);
+		const unsigned short k = reduced.size();
 
-				return;
+		if (k < 3 || k > finishNodes)
+			return false;
+
+		// required adjacency, and the far endpoint of the segment of each endpoint
+		vector<vector<unsigned short>> required(n);
+
+		for (unsigned short i = 0; i < n; i++)
+			for (unsigned short j = i + 1; j < n; j++)
+				if (S.State(i, j) == Forced)
+				{
+					required[i].push_back(j);
+					required[j].push_back(i);
+				}
+
+		for (auto v : reduced)
+			if (required[v].size() == 1 && other[v] == n)
+			{
+				auto p = v, c = required[v][0];
+
+				while (required[c].size() == 2)
+				{
+					auto next = (required[c][0] == p ? required[c][1] : required[c][0]);
+					p = c;
+					c = next;
+				}
+
+				other[v] = c;
+				other[c] = v;
 			}
 
-			M = ceil(numberOfNodes / 4.0f + 5);
-			t = 0;
+		float maxd = 0;
 
-			for (unsigned short i = 0; i < numberOfNodes; i++)
-				t += abs(root.λ[i]);
+		for (auto i : reduced)
+			for (auto j : reduced)
+				if (i != j && other[i] != j && !S.Forbidden(i, j))
+					maxd = max(maxd, distance[i][j]);
 
-			t /= 2.0f * numberOfNodes;
+		const float M = k * maxd + 1;
 
-			auto B = Branch(root.oneTree, δ, root, numberOfNodes);
+		vector<vector<float>> D(k, vector<float>(k, FLT_MAX));
 
-			for (unsigned short i = 0; i < B.size(); i++)
-				if (!Bound(B[i], δ, t, M))
-					if (B[i].bound < UB)
-						PQ_Add(Q, B[i]);
+		for (unsigned short a = 0; a < k; a++)
+			for (unsigned short b = 0; b < k; b++)
+				if (a != b)
+				{
+					auto i = reduced[a];
+					auto j = reduced[b];
+
+					if (other[i] == j)
+						D[a][b] = 1;
+					else if (S.Forbidden(i, j))
+						D[a][b] = distance[i][j] + 2 * k * M;
+					else
+						D[a][b] = distance[i][j] + M;
+				}
+
+		float cost;
+		vector<unsigned short> circuit;
+
+		HeldKarp heldKarp(D);
+		heldKarp.SolveTour(cost, circuit);
+
+		statistics.nodesFinished++;
+
+		// back to the real nodes: the required edges plus the free edges of the circuit
+		sTree T(n);
+		float weight = 0;
+		unsigned short e = 0;
+
+		for (unsigned short i = 0; i < n; i++)
+			for (auto j : required[i])
+				if (i < j)
+					T[e++] = sEdge(i, j);
+
+		for (size_t c = 0; c + 1 < circuit.size(); c++)
+		{
+			auto i = reduced[circuit[c]];
+			auto j = reduced[circuit[c + 1]];
+
+			if (other[i] == j)
+				continue;
+
+			// every tour breaks a constraint
+			if (S.Forbidden(i, j) || e == n)
+				return true;
+
+			T[e++] = sEdge(i, j);
 		}
 
+		if (e < n)
+			return true;
+
+		vector<vector<unsigned short>> adj(n);
+
+		for (unsigned short i = 0; i < n; i++)
 		{
-			vector<unsigned short> δ1(numberOfNodes, 0);
+			adj[T[i].from].push_back(T[i].to);
+			adj[T[i].to].push_back(T[i].from);
+			weight += distance[T[i].from][T[i].to];
+		}
 
-			while (!Q.empty())
+		for (auto &a : adj)
+			if (a.size() != 2)
+				return true;
+
+		// a required cycle would leave the circuit short of n nodes
+		unsigned short p = 0, v = adj[0][0], length = 1;
+
+		while (v != 0)
+		{
+			auto next = (adj[v][0] == p ? adj[v][1] : adj[v][0]);
+			p = v;
+			v = next;
+			length++;
+		}
+
+		if (length == n && weight < UB)
+			UpdateIncumbent(weight, T);
+
+		return true;
+	}
+
+	void Branch_and_Bound::Worker(unsigned short worker, float t, unsigned short M)
+	{
+		vector<unsigned short> δ1(numberOfNodes, 0);
+		sBoundWorkspace BW(numberOfNodes);
+		sNode node;
+
+		BW.S.SetBase(eliminated);
+
+		while (true)
+		{
 			{
-				auto node = Q.back();
-				Q.pop_back();
+				unique_lock<mutex> idle(idleLock);
 
-				if (ceil(node.bound) >= UB)
-				{
-					// exceeded UB
-					opt = UB;
-					path = PrintPath(tour);
+				// asleep while the lists are empty but other workers are still expanding, or a checkpoint waits for the lock
+				idleSignal.wait(idle, [this] { return pendingNodes == 0 || (queuedNodes > 0 && !checkpointPending); });
+
+				if (pendingNodes == 0)
+					break;
+			}
 
-					return;
+			if (arena.Crowded())
+				Reclaim();
+
+			shared_lock<shared_timed_mutex> world(checkpointLock);
+
+			// another worker was faster
+			if (!Pop(worker, node))
+				continue;
+
+			// exceeded UB
+			if (!Dominated(node.bound))
+			{
+				BW.S.Load(node.constraints);
+
+				if (Rebuild(node, BW, δ1))
+				{
+					BW.S.Unload(node.constraints);
+					statistics.nodesPruned++;
 				}
+				else if (!BW.T.CheckTour())
+				{
+					BW.S.Unload(node.constraints);
+					UpdateIncumbent(node.bound, BW.T);
+				}
+				else if (Finish(BW.S))
+				{
+					BW.S.Unload(node.constraints);
+				}
+				else
+				{
+					auto B = Branch(BW.T, δ1, node, BW.S, numberOfNodes);
+					BW.S.Unload(node.constraints);
+
+					statistics.nodesExpanded++;
+					statistics.nodesCreated += B.size();
+
+					for (unsigned short i = 0; i < B.size(); i++)
+						if (!Bound(B[i], BW, δ1, t, M) && !Dominated(B[i].bound))
+						{
+							if (!BW.best.CheckTour())
+								UpdateIncumbent(B[i].bound, BW.best);
+							else
+								Push(worker, B[i]);
+						}
+						else
+						{
+							statistics.nodesPruned++;
+						}
+				}
+
+				for (unsigned short k = 0; k < numberOfNodes; k++)
+					δ1[k] = 0;
+			}
+			else
+			{
+				statistics.nodesPruned++;
+			}
+
+			// the last node: the sleeping workers can leave
+			if (--pendingNodes == 0)
+				Wake(true);
+		}
+	}
+
+	// the constraint records of the pruned and expanded subtrees go back to the arena, with the workers stopped as for a checkpoint
+	void Branch_and_Bound::Reclaim()
+	{
+		checkpointPending = true;
+
+		{
+			unique_lock<shared_timed_mutex> world(checkpointLock);
+
+			// another worker was faster
+			if (arena.Crowded())
+			{
+				vector<const sConstraint*> roots;
+
+				for (auto &L : openLists)
+					for (auto &node : L->Q)
+						roots.push_back(node.constraints);
+
+				arena.Sweep(roots);
+			}
+		}
+
+		checkpointPending = false;
+		Wake(true);
+	}
+
+	// FNV-1a of the distance matrix, a checkpoint is resumed only on the same instance
+	unsigned long long Branch_and_Bound::Checksum()
+	{
+		unsigned long long h = 14695981039346656037ull;
 
-				if (node.bound < UB)
+		for (auto &row : distance)
+		{
+			auto b = reinterpret_cast<const unsigned char*>(row.data());
+
+			for (size_t k = 0; k < row.size() * sizeof(float); k++)
+				h = (h ^ b[k]) * 1099511628211ull;
+		}
+
+		return h;
+	}
+
+	// replaces the checkpoint in one step: there is always either the old or the new file
+	static bool Commit(const string &temp, const string &file)
+	{
+#ifdef _WIN32
+		return MoveFileExA(temp.c_str(), file.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		return rename(temp.c_str(), file.c_str()) == 0;
+#endif
+	}
+
+	/*
+	Binary image of the search, taken while no worker owns a node, in fixed-width little-endian fields:
+	header, incumbent, eliminated edges, statistics, the constraint records reachable from the open lists
+	(parents first, shared prefixes written once), the distinct multiplier vectors and the open nodes.
+	*/
+	void Branch_and_Bound::SaveCheckpoint(float t, unsigned short M)
+	{
+		auto temp = checkpointFile + ".tmp";
+
+		{
+			ofstream file(temp, ios::binary | ios::trunc);
+			BinaryWriter out(file);
+
+			unordered_map<const sConstraint*, uint32_t> id;
+			unordered_map<const vector<float>*, uint32_t> λid;
+			vector<const sConstraint*> records, chain;
+			vector<const vector<float>*> λs;
+			vector<sNode*> nodes;
+
+			id[nullptr] = 0;
+
+			for (auto &L : openLists)
+				for (auto &node : L->Q)
 				{
-					for (unsigned short i = 0; i < numberOfNodes; i++)
-					{
-						δ1[node.oneTree[i].from]++;
-						δ1[node.oneTree[i].to]++;
-					}
+					nodes.push_back(&node);
 
-					if (!node.oneTree.CheckTour())
-					{
-						UB = node.bound;
+					for (auto c = node.constraints; id.count(c) == 0; c = c->parent)
+						chain.push_back(c);
 
-						for (unsigned short i = 0; i < numberOfNodes; i++)
-							tour[i] = node.oneTree[i];
-					}
-					else
+					for (; !chain.empty(); chain.pop_back())
 					{
-						auto B = Branch(node.oneTree, δ1, node, numberOfNodes);
-
-						for (unsigned short i = 0; i < B.size(); i++)
-							if (!Bound(B[i], δ1, t, M))
-								if (B[i].bound < UB)
-								{
-									if (!B[i].oneTree.CheckTour())
-									{
-										UB = B[i].bound;
-
-										for (unsigned short k = 0; k < numberOfNodes; k++)
-											tour[k] = B[i].oneTree[k];
-									}
-
-									PQ_Add(Q, B[i]);
-								}
+						records.push_back(chain.back());
+						id[chain.back()] = static_cast<uint32_t>(records.size());
 					}
+
+					// siblings share the multipliers of their parent
+					if (λid.emplace(node.λ.get(), static_cast<uint32_t>(λs.size())).second)
+						λs.push_back(node.λ.get());
 				}
 
-				for (unsigned short k = 0; k < numberOfNodes; k++)
-					δ1[k] = 0;
+			const auto n = numberOfNodes;
+
+			out.Raw("TSPBB004", 8);
+			out.U16(n);
+			out.U64(Checksum());
+			out.F32(t);
+			out.U16(M);
+			out.F32(UB);
+
+			for (auto &e : tour)
+			{
+				out.U16(e.from);
+				out.U16(e.to);
+			}
+
+			for (auto e : eliminated)
+				out.U8(static_cast<uint8_t>(e));
+
+			statistics.Save(out);
+
+			out.U32(static_cast<uint32_t>(records.size()));
+
+			for (auto c : records)
+			{
+				out.U16(c->edge.from);
+				out.U16(c->edge.to);
+				out.U8(static_cast<uint8_t>(c->type));
+				out.U32(id[c->parent]);
+			}
+
+			out.U32(static_cast<uint32_t>(λs.size()));
+
+			for (auto λ : λs)
+				for (auto x : *λ)
+					out.F32(x);
+
+			out.U32(static_cast<uint32_t>(nodes.size()));
+
+			for (auto node : nodes)
+			{
+				out.F32(node->bound);
+				out.U32(id[node->constraints]);
+				out.U32(λid[node->λ.get()]);
+			}
+
+			file.close();
+
+			// a short write (full disk) never replaces the last good checkpoint
+			if (!file)
+			{
+				remove(temp.c_str());
+				return;
+			}
+		}
+
+		Commit(temp, checkpointFile);
+	}
+
+	// false if there is no checkpoint to resume
+	bool Branch_and_Bound::LoadCheckpoint(float &t, unsigned short &M)
+	{
+		ifstream file(checkpointFile, ios::binary);
+
+		if (!file)
+			return false;
+
+		BinaryReader in(file);
+
+		auto check = [&](bool ok, const char *section)
+		{
+			if (!ok || !in.Good())
+				throw runtime_error("The checkpoint " + checkpointFile + " is truncated or corrupt in the " + section + "!");
+		};
+
+		char magic[8] = { 0 };
+		in.Raw(magic, 8);
+
+		const auto n = in.U16();
+		const auto h = in.U64();
+
+		if (!in.Good() || string(magic, 8) != "TSPBB004" || n != numberOfNodes || h != Checksum())
+			throw runtime_error("The checkpoint " + checkpointFile + " is not of this instance!");
+
+		t = in.F32();
+		M = in.U16();
+		const auto ub = in.F32();
+
+		for (auto &e : tour)
+		{
+			e.from = in.U16();
+			e.to = in.U16();
+		}
+
+		check(true, "incumbent");
+
+		UB = ub;
+
+		eliminated.assign(n * n, Free);
+
+		for (auto &e : eliminated)
+			e = static_cast<Constraints>(in.U8());
+
+		check(true, "eliminated edges");
+
+		candidates.assign(n, vector<unsigned short>());
+
+		for (unsigned short i = 0; i < n; i++)
+			for (unsigned short j = 0; j < n; j++)
+				if (i != j && eliminated[i * n + j] == Free)
+					candidates[i].push_back(j);
+
+		statistics.Load(in);
+		check(true, "statistics");
+
+		const auto r = in.U32();
+		check(true, "constraints");
+
+		vector<const sConstraint*> records(1, nullptr);
+
+		for (uint32_t k = 1; k <= r; k++)
+		{
+			sEdge e;
+			e.from = in.U16();
+			e.to = in.U16();
+
+			auto type = static_cast<Constraints>(in.U8());
+			auto parent = in.U32();
+
+			// parents are written first
+			check(parent < k && e.from < n && e.to < n, "constraints");
+
+			records.push_back(arena.Add(records[parent], e, type));
+		}
+
+		const auto l = in.U32();
+		check(true, "multipliers");
+
+		vector<shared_ptr<const vector<float>>> λs;
+		vector<float> λ(n);
+
+		for (uint32_t k = 0; k < l; k++)
+		{
+			for (auto &x : λ)
+				x = in.F32();
+
+			check(true, "multipliers");
+
+			λs.push_back(make_shared<const vector<float>>(λ));
+		}
+
+		const auto q = in.U32();
+		check(true, "open nodes");
+
+		sNode node;
+
+		for (uint32_t k = 0; k < q; k++)
+		{
+			node.bound = in.F32();
+
+			auto c = in.U32();
+			auto m = in.U32();
+
+			check(c <= r && m < l, "open nodes");
+
+			node.constraints = records[c];
+			node.λ = λs[m];
+
+			// the workers may be more or less than when it was saved
+			openLists[k % numberOfThreads]->Q.push_back(node);
+			pendingNodes++;
+			queuedNodes++;
+		}
+
+		for (auto &L : openLists)
+			make_heap(L->Q.begin(), L->Q.end(), Dearer);
+
+		return true;
+	}
+
+	void Branch_and_Bound::Checkpointer(float t, unsigned short M)
+	{
+		unique_lock<mutex> wait(checkpointWait);
+
+		while (!checkpointSignal.wait_for(wait, seconds(checkpointInterval), [this] { return searchEnded; }))
+		{
+			checkpointPending = true;
+
+			{
+				unique_lock<shared_timed_mutex> world(checkpointLock);
+				SaveCheckpoint(t, M);
+			}
+
+			checkpointPending = false;
+			Wake(true);
+		}
+	}
+
+	// Bound the root and deal its children to the workers; true if the incumbent is already optimal
+	bool Branch_and_Bound::Root(float &t, unsigned short &M)
+	{
+		// Upper bound on tour 0-1-2-.....-n
+		UB = distance[numberOfNodes - 1][0];
+		tour[0] = sEdge(numberOfNodes - 1, 0);
+
+		for (unsigned short i = 0; i < distance.size() - 1; i++)
+		{
+			UB = UB + distance[i][i + 1];
+			tour[i + 1] = sEdge(i, i + 1);
+		}
+
+		// the heuristic runs while the root is bounded
+		future<vector<unsigned short>> heuristic;
+
+		if (warmStart != WarmStart::Identity && numberOfNodes > 3)
+			heuristic = async(launch::async, &Branch_and_Bound::Heuristic, this);
+
+		t = t1();
+		M = numberOfNodes * numberOfNodes / 50 + numberOfNodes + 15;
+
+		// Calculate first Bound
+		vector<unsigned short> δ(numberOfNodes, 0);
+		sBoundWorkspace BW(numberOfNodes);
+
+		sNode root(numberOfNodes);
+		Bound(root, BW, δ, t, M);
+
+		statistics.nodesCreated++;
+
+		if (!BW.best.CheckTour())
+		{
+			UB = root.bound;
+
+			for (unsigned short i = 0; i < numberOfNodes; i++)
+				tour[i] = BW.best[i];
+
+			return true;
+		}
+
+		if (heuristic.valid())
+		{
+			auto H = heuristic.get();
+			auto cost = LocalSearch<>(distance).Cost(H);
+
+			if (cost < UB)
+			{
+				UB = cost;
+				statistics.Incumbent(cost);
+
+				for (unsigned short i = 0; i < numberOfNodes; i++)
+					tour[i] = sEdge(H[i], H[(i + 1) % numberOfNodes]);
+			}
+		}
+
+		// the incumbent is optimal
+		if (Dominated(root.bound) || !EliminateEdges(root, BW.best))
+			return true;
+
+		BW.S.SetBase(eliminated);
+
+		for (unsigned short i = 0; i < numberOfNodes; i++)
+			for (unsigned short j = i + 1; j < numberOfNodes; j++)
+				if (eliminated[i * numberOfNodes + j] == Forbidden)
+					statistics.edgesEliminated++;
+
+		M = ceil(numberOfNodes / 4.0f + 5);
+		t = 0;
+
+		for (unsigned short i = 0; i < numberOfNodes; i++)
+			t += abs((*root.λ)[i]);
+
+		t /= 2.0f * numberOfNodes;
+
+		auto B = Branch(BW.best, δ, root, BW.S, numberOfNodes);
+
+		statistics.nodesExpanded++;
+		statistics.nodesCreated += B.size();
+
+		// deal the children of the root to the workers
+		for (unsigned short i = 0; i < B.size(); i++)
+			if (!Bound(B[i], BW, δ, t, M) && !Dominated(B[i].bound))
+				Push(i % numberOfThreads, B[i]);
+			else
+				statistics.nodesPruned++;
+
+		return false;
+	}
+
+	void Branch_and_Bound::Search(float &opt, string &path)
+	{
+		float t;
+		unsigned short M;
+
+		tour.assign(numberOfNodes, sEdge());
+
+		openLists.clear();
+		for (unsigned short w = 0; w < numberOfThreads; w++)
+			openLists.push_back(make_unique<sOpenList>());
+
+		pendingNodes = 0;
+		queuedNodes = 0;
+		arena.Clear();
+		candidates.clear();
+
+		if (checkpointFile.empty() || !LoadCheckpoint(t, M))
+			if (Root(t, M))
+			{
+				opt = UB;
+				path = PrintPath(tour);
+
+				return;
+			}
+
+		{
+			vector<thread> workers;
+			thread checkpointer;
+
+			searchEnded = false;
+
+			if (!checkpointFile.empty())
+				checkpointer = thread(&Branch_and_Bound::Checkpointer, this, t, M);
+
+			for (unsigned short w = 0; w < numberOfThreads; w++)
+				workers.push_back(thread(&Branch_and_Bound::Worker, this, w, t, M));
+
+			for (auto &w : workers)
+				w.join();
+
+			if (checkpointer.joinable())
+			{
+				{
+					lock_guard<mutex> guard(checkpointWait);
+					searchEnded = true;
+				}
+
+				checkpointSignal.notify_all();
+				checkpointer.join();
+
+				// the open lists are empty: resuming returns the optimum at once
+				SaveCheckpoint(t, M);
 			}
 		}
 
@@ -503,4 +1414,17 @@ namespace TSP
 		path = PrintPath(tour);
 	}
 
+	void Branch_and_Bound::Solve(float &opt, string &path)
+	{
+		statistics.Reset();
+
+		Search(opt, path);
+
+		if (!statisticsFile.empty())
+		{
+			ofstream file(statisticsFile);
+			file << statistics.ToJSON();
+		}
+	}
+
 }
\ No newline at end of file
@@ -6,11 +6,21 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "Base/TSP.hpp"
+#include "AscentTrace.hpp"
+#include "Statistics.hpp"
 #include "../ADS/sGraph.hpp"
+#include "../MST/Prim.hpp"
 
 using namespace std;
 using namespace ADS;
@@ -19,44 +29,153 @@ namespace TSP
 {
 	class Branch_and_Bound : public Base::TSP
 	{
+	public:
+		// heuristic giving the first upper bound
+		enum class WarmStart
+		{
+			Identity,
+			ApproxTSP,
+			Christofides
+		};
+
 	private:
-		unsigned short CountElements(vector<sEdge> &edges, vector<unsigned short> &from, unsigned short i)
+		// open list owned by a worker, other workers steal from it when their own is empty; a binary heap on the bound
+		struct sOpenList
 		{
-			unsigned short x = 0;
+			mutex lock;
+			vector<sNode> Q;
+		};
 
-			for (auto f : edges)
-			{
-				if (f.from == i)
-				{
-					from[f.to] = 1;
-					x++;
-				}
+		// scratch memory of a worker, reused by every Bound it evaluates: the 1-tree and multipliers of the current step and the best ones
+		struct sBoundWorkspace
+		{
+			sConstraintState S;
+			MST::sDenseWorkspace prim;
+			sTree T, best;
+			vector<float> λ, Λ;
+
+			sBoundWorkspace(unsigned short size) : S(size), prim(size), T(size), best(size), λ(size), Λ(size) {}
+		};
+
+		// subproblems with at most this many segment endpoints and free nodes are solved by HeldKarp, 0 never:
+		// the nodes expanded keep almost all of their n nodes free, and a HeldKarp on 14 costs about 30 bounds of rd100
+		unsigned short finishNodes = 0;
+
+	private:
+		const unsigned short numberOfThreads;
+		const WarmStart warmStart;
+
+		// relative tolerance of the prune: the costs are unrounded floats, a bound is never rounded up to the next integer
+		static constexpr float ε = 1e-6f;
+
+		// incumbent shared by all the workers
+		atomic<float> UB;
+		mutex incumbentLock;
+		vector<sEdge> tour;
+
+		// constraints of all the subproblems
+		sConstraintArena arena;
+
+		// edges eliminated at the root and the sparse graph that remains
+		vector<Constraints> eliminated;
+		vector<vector<unsigned short>> candidates;
+
+		vector<unique_ptr<sOpenList>> openLists;
+
+		// nodes in the open lists or being expanded, and only those in the open lists
+		atomic<size_t> pendingNodes;
+		atomic<size_t> queuedNodes;
 
-				if (f.to == i)
+		// idle workers sleep here until a node is pushed, the search ends or a checkpoint is over
+		mutex idleLock;
+		condition_variable idleSignal;
+
+		Statistics statistics;
+		string statisticsFile;
+
+		// off when null
+		AscentTrace *trace = nullptr;
+
+		// periodic checkpoint: the workers hold checkpointLock shared while they own a node
+		string checkpointFile;
+		unsigned int checkpointInterval = 0;
+		shared_timed_mutex checkpointLock;
+		atomic<bool> checkpointPending;
+		mutex checkpointWait;
+		condition_variable checkpointSignal;
+		bool searchEnded;
+
+	private:
+		// marks the vertices joined to i by a forbidden edge
+		unsigned short CountElements(sConstraintState &S, vector<unsigned short> &from, unsigned short i)
+		{
+			unsigned short x = 0;
+
+			for (unsigned short k = 0; k < S.n; k++)
+				if (S.Forbidden(i, k))
 				{
-					from[f.from] = 1;
+					from[k] = 1;
 					x++;
 				}
-			}
 
 			return x;
 		}
 
 	private:
-		bool Bound(sNode &node, vector<unsigned short> &δ, float t, unsigned short const steps);
-		vector<sNode> Branch(sTree &T, vector<unsigned short> &δ, sNode &current_node, unsigned short n);
+		bool Required(const sConstraint *constraints, const sConstraintState &S, unsigned short &req1, unsigned short &req2, unsigned short &req);
+		bool OneTree(sBoundWorkspace &BW, const vector<float> &λ, unsigned short req1, unsigned short req2, unsigned short req);
+		bool Rebuild(const sNode &node, sBoundWorkspace &BW, vector<unsigned short> &δ);
+		bool Bound(sNode &node, sBoundWorkspace &BW, vector<unsigned short> &δ, float t, unsigned short const steps);
+		vector<sNode> Branch(sTree &T, vector<unsigned short> &δ, sNode &current_node, sConstraintState &S, unsigned short n);
+		void Constrain(const sConstraint *&child, bool &feasible, sConstraintState &S, sEdge e, Constraints c);
 
 		float t1();
 
+		vector<unsigned short> Heuristic();
+		bool EliminateEdges(const sNode &root, const sTree &T);
+
+		static bool Dearer(const sNode &l, const sNode &r);
+		bool Dominated(float bound) const;
 		void PQ_Add(vector<sNode> &L, sNode &new_elem);
+		void Wake(bool all);
+
+		void Push(unsigned short worker, sNode &node);
+		bool Pop(unsigned short worker, sNode &node);
+
+		void UpdateIncumbent(float cost, const sTree &T);
+		bool Finish(sConstraintState &S);
+		void Worker(unsigned short worker, float t, unsigned short M);
+		void Reclaim();
+
+		unsigned long long Checksum();
+		void SaveCheckpoint(float t, unsigned short M);
+		bool LoadCheckpoint(float &t, unsigned short &M);
+		void Checkpointer(float t, unsigned short M);
+
+		bool Root(float &t, unsigned short &M);
+		void Search(float &opt, string &path);
 
 	protected:
 		string PrintPath(vector<sEdge> &path);
 
+		void ETLw();
 		void Solve(float &opt, string &path);
 
 	public:
-		Branch_and_Bound(const vector<vector<float>> &DistanceMatrix2D);
+		Branch_and_Bound(const vector<vector<float>> &DistanceMatrix2D, unsigned short threads = 0, WarmStart warmStart = WarmStart::Christofides);
+
+		// the statistics are written as JSON to fileName at the end of Solve
+		void SetStatisticsFile(const string &fileName);
+		Statistics &GetStatistics();
+
+		// the search is saved to fileName every interval seconds; a checkpoint of the same instance found there is resumed by Solve
+		void SetCheckpoint(const string &fileName, unsigned int interval = 60);
+
+		// every iteration of Bound is written to trace, null to stop
+		void SetTrace(AscentTrace *trace);
+
+		// HeldKarp closes the subproblems reduced to at most nodes endpoints and free nodes, 0 to disable
+		void SetFinish(unsigned short nodes);
 
 	};
 }
\ No newline at end of file
@@ -12,15 +12,32 @@ The problem can be described as: find a tour of N cities in a country (assuming
 */
 #pragma once
 
-#include <stack>
+#include <algorithm>
+#include <cstdint>
 
 #include "Christofides.hpp"
+#include "LocalSearch.hpp"
+#include "../ADS/PointGrid.hpp"
 #include "../MST/Prim.hpp"
 #include "../Matching/Blossom.hpp"
+#include "../Matching/Greedy.hpp"
 
 namespace TSP
 {
-	Christofides::Christofides(const vector<vector<float>> &DistanceMatrix2D) : TSP(DistanceMatrix2D) {}
+	Christofides::Christofides(const vector<vector<float>> &DistanceMatrix2D, MatchingMode matchingMode) :
+		TSP(DistanceMatrix2D),
+		matchingMode(matchingMode) {}
+
+	void Christofides::SetCoordinates(const vector<pair<float, float>> &coordinates)
+	{
+		this->coordinates = coordinates;
+	}
+
+	void Christofides::SetLocalSearch(bool enabled, float seconds)
+	{
+		localSearch = enabled;
+		localSearchSeconds = seconds;
+	}
 
 	float Christofides::CalcCost(vector<unsigned short> &circuit) // O(V)
 	{
@@ -49,78 +66,159 @@ namespace TSP
 	}
 
 	// 1. Create a minimum spanning tree T of G.
-	vector<set<unsigned short>> Christofides::MST(Graph &G) // O(E ㏒ V)
+	vector<pair<unsigned short, unsigned short>> Christofides::MST(CompleteGraph &G) // O(V²)
 	{
-		vector<set<unsigned short>> T(numberOfNodes);
+		vector<pair<unsigned short, unsigned short>> T;
+		T.reserve(numberOfNodes - 1);
 
 		MST::Prim prim;
-		prim.Solve(distance, G, 0); // O(E ㏒ V)
+		auto π = prim.Solve(G, 0); // O(V²)
 
-		for (auto u : G.V)
-			if (u->π)
-			{
-				T[u->id].insert(u->π->id);
-				T[u->π->id].insert(u->id);
-			}
+		for (unsigned short u = 0; u < numberOfNodes; u++)
+			if (π[u] != UINT16_MAX)
+				T.emplace_back(u, π[u]);
 
 		return T;
 	}
 
 	// 2. Let O be the set of vertices with odd degree in T.
-	set<unsigned short> Christofides::OddVertices(vector<set<unsigned short>> &T) // O(V)
+	vector<unsigned short> Christofides::OddVertices(vector<pair<unsigned short, unsigned short>> &T) // O(V)
 	{
-		set<unsigned short> O;
+		vector<unsigned short> degree(numberOfNodes, 0), O;
+
+		for (auto &e : T)
+		{
+			degree[e.first]++;
+			degree[e.second]++;
+		}
 
 		for (unsigned short i = 0; i < numberOfNodes; i++)
-			if (T[i].size() % 2 != 0)
-				O.insert(i);
+			if (degree[i] % 2 != 0)
+				O.push_back(i);
 
 		return O;
 	}
 
-	// 3.b induced subgraph given by the vertices from O.
-	shared_ptr<Graph> Christofides::SubGraph(Graph &G, set<unsigned short> O) // O(E)
+	// 3. Find a minimum - weight perfect matching M in the induced subgraph given by the vertices from O.		
+	vector<pair<unsigned short, unsigned short>> Christofides::PerfectMatching(vector<unsigned short> &O) // O(V³)
 	{
-		Graph I(O);
-		I.MakeConnected(distance);
+		if (matchingMode == MatchingMode::Greedy)
+		{
+			Matching::Greedy greedy(MatchingNeighbours);
 
-		return make_shared<Graph>(I);
-	}
+			if (coordinates.empty())
+				return greedy.Solve(CompleteGraph(distance, O)); // O(V²)
+
+			vector<pair<float, float>> points;
+
+			for (auto v : O)
+				points.push_back(coordinates[v]);
+
+			ADS::PointGrid grid(points);
+			vector<vector<unsigned short>> near(O.size());
+
+			for (unsigned short i = 0; i < O.size(); i++)
+				near[i] = grid.Nearest(i, MatchingNeighbours);
+
+			return greedy.Solve(CompleteGraph(distance, O), &near); // O(V·k ㏒ V)
+		}
 
-	// 3. Find a minimum - weight perfect matching M in the induced subgraph given by the vertices from O.		
-	set<shared_ptr<Edge>> Christofides::PerfectMatching(shared_ptr<Graph> G) // O(V²E)
-	{
 		Matching::Blossom blossom;
-		return blossom.Solve(G); // O(V²E)
+		return blossom.Solve(CompleteGraph(distance, O)); // O(V³)
 	}
 
 	// 4. Combine the edges of M and T to form a connected multigraph H
-	vector<set<unsigned short>> Christofides::Multigraph(vector<set<unsigned short>> &T, set<shared_ptr<Edge>> &M) // O(E)
+	Christofides::sMultigraph Christofides::Multigraph(vector<pair<unsigned short, unsigned short>> &T, vector<pair<unsigned short, unsigned short>> &M) // O(V)
 	{
-		auto H = T; // copy
+		sMultigraph H;
+		H.first.assign(numberOfNodes + 1, 0);
+
+		const unsigned int m = T.size() + M.size();
+		auto edge = [&](unsigned int i) -> pair<unsigned short, unsigned short>& { return i < T.size() ? T[i] : M[i - T.size()]; };
 
-		for (auto m : M)
+		for (unsigned int i = 0; i < m; i++)
 		{
-			if (H[m->from->id].count(m->to->id) == 0)
-				H[m->from->id].insert(m->to->id);
+			H.first[edge(i).first + 1]++;
+			H.first[edge(i).second + 1]++;
+		}
+
+		for (unsigned short u = 0; u < numberOfNodes; u++)
+			H.first[u + 1] += H.first[u];
+
+		H.to.resize(2 * m);
+		H.edge.resize(2 * m);
+
+		auto next = H.first;
 
-			if (H[m->to->id].count(m->from->id) == 0)
-				H[m->to->id].insert(m->from->id);
+		for (unsigned int i = 0; i < m; i++)
+		{
+			auto &e = edge(i);
+
+			H.to[next[e.first]] = e.second;
+			H.edge[next[e.first]++] = i;
+
+			H.to[next[e.second]] = e.first;
+			H.edge[next[e.second]++] = i;
 		}
 
 		return H;
 	}
 
-	// 5. Form an Eulerian circuit in H.
+	// 5. Form an Eulerian circuit in H (Hierholzer, iterative).
+	vector<unsigned short> Christofides::Eulerian(sMultigraph &H) // O(V)
+	{
+		vector<unsigned short> circuit, stack{ 0 };
+		vector<unsigned int> next(H.first.begin(), H.first.end() - 1);
+		vector<bool> used(H.edge.size() / 2, false);
+
+		circuit.reserve(used.size() + 1);
+
+		while (!stack.empty())
+		{
+			auto u = stack.back();
+
+			while (next[u] < H.first[u + 1] && used[H.edge[next[u]]])
+				next[u]++;
+
+			if (next[u] == H.first[u + 1])
+			{
+				circuit.push_back(u);
+				stack.pop_back();
+			}
+			else
+			{
+				used[H.edge[next[u]]] = true;
+				stack.push_back(H.to[next[u]++]);
+			}
+		}
+
+		return circuit;
+	}
+
 	// 6. Make the circuit found in previous step into a Hamiltonian circuit by skipping repeated vertices (shortcutting).
-	void Christofides::Hamiltonian(vector<set<unsigned short>> &H, vector<unsigned short> &E, set<unsigned short> &visited, unsigned short c) // O(V)
+	// The closed circuit is walked from position start, forwards or backwards; E starts and ends at 0.
+	float Christofides::Hamiltonian(vector<unsigned short> &eulerian, vector<unsigned short> &E, size_t start, bool reverse) // O(V)
 	{
-		visited.insert(c);
-		E.push_back(c);
+		const size_t m = eulerian.size() - 1; // the last vertex repeats the first
+		vector<bool> visited(numberOfNodes, false);
 
-		for (auto e : H[c])
-			if (visited.count(e) == 0)
-				Hamiltonian(H, E, visited, e);
+		E.clear();
+
+		for (size_t k = 0; k < m; k++)
+		{
+			auto u = eulerian[reverse ? (start + m - k) % m : (start + k) % m];
+
+			if (!visited[u])
+			{
+				visited[u] = true;
+				E.push_back(u);
+			}
+		}
+
+		rotate(E.begin(), find(E.begin(), E.end(), 0), E.end());
+		E.push_back(0);
+
+		return CalcCost(E);
 	}
 
 	/*
@@ -138,27 +236,23 @@ namespace TSP
 		5. Form an Eulerian circuit in H.
 		6. Make the circuit found in previous step into a Hamiltonian circuit by skipping repeated vertices (shortcutting).
 	*/
-	void Christofides::Solve(float &opt, string &path) // O(V²E)
+	void Christofides::SolveTour(float &opt, vector<unsigned short> &E) // O(V³)
 	{
-		maxCardinality = 11;
+		maxCardinality = (localSearch ? 12 : 11);
 
-		Graph G(distance); // O(V+E)
+		CompleteGraph G(distance); // O(1)
 		currentCardinality = 1;
 
 		// 1. Create a minimum spanning tree T of G.
-		auto T = MST(G); // O(E ㏒ V)
+		auto T = MST(G); // O(V²)
 		currentCardinality = 3;
 
 		// 2. Let O be the set of vertices with odd degree in T.
 		auto O = OddVertices(T);
 		currentCardinality = 4;
 
-		// 3.b induced subgraph given by the vertices from O.
-		auto IG = SubGraph(G, O);
-		currentCardinality = 5;
-
 		// 3. Find a minimum - weight perfect matching M in the induced subgraph given by the vertices from O.		
-		auto M = PerfectMatching(IG); // O(V²E)
+		auto M = PerfectMatching(O); // O(V³)
 		currentCardinality = 6;
 
 		// 4. Combine the edges of M and T to form a connected multigraph H
@@ -166,18 +260,54 @@ namespace TSP
 		currentCardinality = 7;
 
 		// 5. Form an Eulerian circuit in H.
+		auto eulerian = Eulerian(H);
+		currentCardinality = 8;
+
 		// 6. Make the circuit found in previous step into a Hamiltonian circuit by skipping repeated vertices (shortcutting).
-		vector<unsigned short> E;
+		// Different starting points and directions skip different repetitions: keep the cheapest.
+		opt = Hamiltonian(eulerian, E, 0, false);
+		currentCardinality = 10;
+
 		{
-			set<unsigned short> visited;
-			Hamiltonian(H, E, visited, 0);
+			vector<unsigned short> candidate;
+			const size_t m = eulerian.size() - 1;
+
+			for (unsigned short v = 0; v < ShortcutVariants; v++)
+				for (auto reverse : { false, true })
+				{
+					if (v == 0 && !reverse)
+						continue;
+
+					auto cost = Hamiltonian(eulerian, candidate, m * v / ShortcutVariants, reverse);
+
+					if (cost < opt)
+					{
+						opt = cost;
+						E.swap(candidate);
+					}
+				}
+		}
+		currentCardinality = 11;
+
+		if (localSearch)
+		{
+			E.pop_back();
+
+			opt = ImproveTour(distance, E, localSearchSeconds); // O(V·k) per pass
+
+			rotate(E.begin(), find(E.begin(), E.end(), 0), E.end());
 			E.push_back(0);
+
+			currentCardinality = 12;
 		}
-		currentCardinality = 10;
+	}
+
+	void Christofides::Solve(float &opt, string &path)
+	{
+		vector<unsigned short> E;
+		SolveTour(opt, E);
 
-		opt = CalcCost(E);
 		path = PrintPath(E);
-		currentCardinality = 11;
 	}
 
 }
\ No newline at end of file
@@ -8,12 +8,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <memory>
 
-#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Base/TSP.hpp"
-#include "../ADS/Graph.hpp"
+#include "../ADS/CompleteGraph.hpp"
 
 using namespace ADS;
 using namespace std;
@@ -22,13 +22,45 @@ namespace TSP
 {
 	class Christofides : public Base::TSP
 	{
+	public:
+		// step 3: exact minimum weight matching (dense, quadratic memory in the odd nodes), or greedy on nearest neighbours improved by 2-opt
+		enum class MatchingMode
+		{
+			Exact,
+			Greedy
+		};
+
+	private:
+		// multigraph H in CSR form: the arcs of u are arc[first[u]..first[u + 1]), parallel edges kept
+		struct sMultigraph
+		{
+			vector<unsigned int> first;
+			vector<unsigned short> to;
+			vector<unsigned int> edge;
+		};
+
+		// number of shortcut variants tried on the Eulerian circuit
+		static constexpr unsigned short ShortcutVariants = 8;
+
+		// candidates of each odd vertex in the greedy matching
+		static constexpr unsigned short MatchingNeighbours = 10;
+
+		const MatchingMode matchingMode;
+
+		// 2-opt and Or-opt on the final tour, or iterated Lin–Kernighan for localSearchSeconds
+		bool localSearch = false;
+		float localSearchSeconds = 0;
+
+		// the cities in the plane, if known: the greedy matching finds its candidates on a grid instead of scanning all the pairs
+		vector<pair<float, float>> coordinates;
+
 	private:
-		vector<set<unsigned short>> MST(Graph &G);
-		set<unsigned short> OddVertices(vector<set<unsigned short>> &T);
-		shared_ptr<Graph> SubGraph(Graph &G, set<unsigned short> O);
-		set<shared_ptr<Edge>> PerfectMatching(shared_ptr<Graph> G);
-		vector<set<unsigned short>> Multigraph(vector<set<unsigned short>> &T, set<shared_ptr<Edge>> &M);
-		void Hamiltonian(vector<set<unsigned short>> &H, vector<unsigned short> &E, set<unsigned short> &visited, unsigned short c);
+		vector<pair<unsigned short, unsigned short>> MST(CompleteGraph &G);
+		vector<unsigned short> OddVertices(vector<pair<unsigned short, unsigned short>> &T);
+		vector<pair<unsigned short, unsigned short>> PerfectMatching(vector<unsigned short> &O);
+		sMultigraph Multigraph(vector<pair<unsigned short, unsigned short>> &T, vector<pair<unsigned short, unsigned short>> &M);
+		vector<unsigned short> Eulerian(sMultigraph &H);
+		float Hamiltonian(vector<unsigned short> &eulerian, vector<unsigned short> &E, size_t start, bool reverse);
 
 	protected:
 		float CalcCost(vector<unsigned short> &circuit);
@@ -37,7 +69,14 @@ namespace TSP
 		void Solve(float &opt, string &path);
 
 	public:
-		Christofides(const vector<vector<float>> &DistanceMatrix2D);
+		Christofides(const vector<vector<float>> &DistanceMatrix2D, MatchingMode matchingMode = MatchingMode::Exact);
+
+		void SetLocalSearch(bool enabled, float seconds = 0);
+
+		// coordinates of the Euclidean instance behind the distance matrix
+		void SetCoordinates(const vector<pair<float, float>> &coordinates);
+
+		void SolveTour(float &opt, vector<unsigned short> &circuit);
 
 	};
 }
\ No newline at end of file
@@ -174,7 +174,7 @@ namespace TSP
 		08		return (opt)
 		09	end function
 	*/
-	void HeldKarp::Solve(float &opt, string &path)
+	void HeldKarp::Tabulate(bool progress)
 	{
 		// TSP ================================================================================================================================
 		// ALGO[01:02]
@@ -197,17 +197,23 @@ namespace TSP
 			Combinations(currentCardinality, numberOfNodes - 1); // O(2ⁿ) genera (2^s)-1 insiemi differenti di cardinalità s // ALGO[04]
 
 			C.pop();
-			ETLw();
+
+			if (progress)
+				ETLw();
 		}
 		// ALGO[03:06]
 		// TSP ================================================================================================================================
+	}
 
+	// ALGO[07:08], π is the last node before 0
+	unsigned int HeldKarp::Close(unsigned short &π)
+	{
 		// PATH ===============================================================================================================================
 		// ALGO[07:08]
 		{
-			unsigned short π = 0;
+			float opt = FLT_MAX;
 			float tmp;
-			opt = FLT_MAX;
+			π = 0;
 
 			vector<unsigned short> FullSet;
 			for (unsigned short z = 1; z < numberOfNodes; z++)
@@ -230,9 +236,41 @@ namespace TSP
 			C.front()[code][π].cost = opt;
 			C.front()[code][π].path.push_back(π);
 
-			CalcPath(code, π, opt, path);
+			return code;
 		}
 		// ALGO[07:08]
 		// PATH ===============================================================================================================================	
 	}
+
+	void HeldKarp::Solve(float &opt, string &path)
+	{
+		unsigned short π;
+
+		Tabulate(true);
+
+		auto code = Close(π);
+
+		CalcPath(code, π, opt, path);
+	}
+
+	void HeldKarp::SolveTour(float &opt, vector<unsigned short> &circuit)
+	{
+		unsigned short π;
+
+		Tabulate(false);
+
+		auto code = Close(π);
+
+		circuit.assign(1, 0);
+		opt = 0;
+
+		for (const auto e : C.front()[code][π].path)
+		{
+			opt += distance[circuit.back()][e];
+			circuit.push_back(e);
+		}
+
+		opt += distance[circuit.back()][0];
+		circuit.push_back(0);
+	}
 }
\ No newline at end of file
@@ -39,10 +39,16 @@ namespace TSP
 		void Combinations(const unsigned short K, const unsigned short N);
 		void Combinations_FreeMem(stack<unsigned short> &Q, vector<unsigned short> &S, const unsigned short K, const unsigned short N, const unsigned short sCur);
 
+		void Tabulate(bool progress);
+		unsigned int Close(unsigned short &π);
+
 		void Solve(float &opt, string &path);
 
 	public:
 		HeldKarp(const vector<vector<float>> &DistanceMatrix2D);
 
+		// optimal circuit from 0 back to 0, without progress output
+		void SolveTour(float &opt, vector<unsigned short> &circuit);
+
 	};
 }
\ No newline at end of file
@@ -12,121 +12,496 @@ The problem can be described as: find a tour of N cities in a country (assuming
 */
 #pragma once
 
-#include <set>
+#include <algorithm>
+#include <thread>
 
 #include "LagrangianRelaxation.hpp"
 #include "ApproxTSP.hpp"
+#include "LocalSearch.hpp"
 
-#include "../ADS/Graph.hpp"
-#include "../MST/Kruskal.hpp"
+#include "../MST/Prim.hpp"
 
 namespace TSP
 {
-	LagrangianRelaxation::LagrangianRelaxation(const vector<vector<float>> &DistanceMatrix2D) : TSP(DistanceMatrix2D) {}
+	LagrangianRelaxation::LagrangianRelaxation(const vector<vector<float>> &DistanceMatrix2D, bool portfolio) :
+		TSP(DistanceMatrix2D),
+		portfolio(portfolio),
+		oneTree(DistanceMatrix2D.size()) {}
 
-	string LagrangianRelaxation::PrintPath()
+	string LagrangianRelaxation::PrintPath(const vector<unsigned short> &tour)
 	{
 		string s;
+		auto first = find(tour.begin(), tour.end(), 0) - tour.begin();
 
-		return s;
+		for (size_t k = 0; k < tour.size(); k++)
+			s += to_string(tour[(first + k) % tour.size()]) + " ";
+
+		return s + "0";
+	}
+
+	string LagrangianRelaxation::Report()
+	{
+		stringstream ss;
+		ss << ", LB: " << LB << ", gap: " << 100 * Gap() << "%";
+
+		return ss.str();
+	}
+
+	void LagrangianRelaxation::SetTrace(AscentTrace *trace)
+	{
+		this->trace = trace;
+	}
+
+	float LagrangianRelaxation::LowerBound()
+	{
+		return LB;
+	}
+
+	float LagrangianRelaxation::Gap()
+	{
+		return (UB - LB) / LB;
 	}
 
 	float LagrangianRelaxation::UpperBound()
 	{
 		float opt;
-		string path;
+		vector<unsigned short> circuit;
 
 		ApproxTSP approxTSP(distance);
-		approxTSP.SilentSolve(opt, path);
+		approxTSP.SolveTour(opt, circuit);
+
+		// target of the Polyak steps, the closer the better
+		circuit.pop_back();
+
+		LocalSearch<> localSearch(distance);
+
+		return localSearch.Improve(circuit);
+	}
+
+	// 1-tree at node 0 on w[i][j] = distance[i][j] + λ[i] + λ[j]: dense Prim on 1..n-1 and the two cheapest edges at 0
+	void LagrangianRelaxation::OneTree(sTree &T, MST::sDenseWorkspace &W, const vector<float> &λ) // O(V²)
+	{
+		MST::Prim prim;
+		prim.Solve(T, W, distance, λ);
 
-		return opt;
+		float min1 = FLT_MAX;
+		float min2 = FLT_MAX;
+
+		unsigned short id1 = 1, id2 = 2;
+
+		for (unsigned short i = 1; i < numberOfNodes; i++)
+		{
+			auto w = distance[0][i] + λ[0] + λ[i];
+
+			if (w < min1)
+			{
+				min2 = min1;
+				id2 = id1;
+
+				min1 = w;
+				id1 = i;
+			}
+			else if (w < min2)
+			{
+				min2 = w;
+				id2 = i;
+			}
+		}
+
+		T[numberOfNodes - 2] = sEdge(0, id1);
+		T[numberOfNodes - 1] = sEdge(0, id2);
 	}
 
-	shared_ptr<Graph> LagrangianRelaxation::LagrangeSubGradient(Graph &G, float &best_zero_tree_cost)
+	/*
+	Subgradient ascent on flat arrays, the λ-adjusted costs are never stored. Step size t_k by schedule:
+	- VolgenantJonker: quadratic decrease from t_1, along 0.6 of the current and 0.4 of the previous subgradient;
+	- HeldWolfeCrowder: α (UB - W) / |g|², α from 2 halved at fixed periods of n / 2 iterations;
+	- Polyak: α (UB - W) / |g|², α from 1 halved when the bound stops rising.
+	With shared the best bound is exchanged every Exchange iterations, and a schedule that lags behind restarts from the best λ.
+	*/
+	float LagrangianRelaxation::LagrangeSubGradient(Schedule schedule, sTree &best_one_tree, vector<float> &best_λ, sPortfolio *shared)
 	{
+		const unsigned short Exchange = 25;
+
 		auto t_1 = 0.0f;
 		auto t_k = 0.0f;
+		auto α = (schedule == Schedule::HeldWolfeCrowder ? 2.0f : 1.0f);
 
 		unsigned short k = 0;
 		unsigned short M = ((numberOfNodes * numberOfNodes) / 50) + numberOfNodes + 16;
 
-		maxCardinality = M;
+		const unsigned short period = max(numberOfNodes / 2, 10);
+		unsigned short stagnation = 0;
+
+		// only one schedule moves the progress
+		const auto progress = (schedule == Schedule::VolgenantJonker);
+
+		if (progress)
+			maxCardinality = M;
 
 		auto constraint1 = 2.0f * (M - 1.0f) * (M - 2.0f);
 		auto constraint2 = M * (2.0f * M - 3.0f);
 
-		MST::Kruskal kruskal;
+		float best_one_tree_cost = -FLT_MAX;
+
+		sTree T(numberOfNodes);
+		MST::sDenseWorkspace W(numberOfNodes);
 
-		map<unsigned short, unsigned short> d_k_prev;
-		vector<float> π(numberOfNodes, 0);
+		vector<float> λ(numberOfNodes, 0);
+		vector<unsigned short> d_k(numberOfNodes), d_k_prev(numberOfNodes);
 
-		shared_ptr<Graph> best_zero_tree;
+		const char *names[] = { "VJ", "HWC", "Polyak" };
+		const auto ascent = (trace ? trace->NewAscent() : 0);
 
 		while (k < M)
 		{
 			k++;
-			currentCardinality++;
 
-			auto zero_tree = kruskal.Solve(G);
+			if (progress)
+				currentCardinality++;
 
-			if (zero_tree->E.size() == 0)
-				break;
+			OneTree(T, W, λ);
 
-			auto d_k = zero_tree->Degree();
+			auto one_tree_cost = 0.0f;
+			auto norm = 0.0f;
+			unsigned short violations = 0;
+
+			fill(d_k.begin(), d_k.end(), 0);
+
+			for (unsigned short i = 0; i < numberOfNodes; i++)
+			{
+				d_k[T[i].from]++;
+				d_k[T[i].to]++;
+
+				one_tree_cost += distance[T[i].from][T[i].to] + λ[T[i].from] + λ[T[i].to];
+			}
+
+			for (unsigned short i = 0; i < numberOfNodes; i++)
+			{
+				one_tree_cost -= 2.0f * λ[i];
+				norm += (d_k[i] - 2) * (d_k[i] - 2);
+
+				if (d_k[i] != 2)
+					violations++;
+			}
 
 			if (k == 1)
 				d_k_prev = d_k;
 
-			auto zero_tree_cost = zero_tree->Cost();
+			if (one_tree_cost > best_one_tree_cost)
+			{
+				best_one_tree_cost = one_tree_cost;
+				best_one_tree = T;
+				best_λ = λ;
+				stagnation = 0;
 
-			for (unsigned short i = 0; i < numberOfNodes; i++)
-				zero_tree_cost += π[i] * 2.0f;
+				t_1 = 0.01f * one_tree_cost;
+			}
+			else if (++stagnation >= period && schedule == Schedule::Polyak)
+			{
+				α /= 2;
+				stagnation = 0;
+			}
 
-			if (zero_tree_cost > best_zero_tree_cost || k == 1)
+			// the 1-tree is a tour (optimal), or no tour is cheaper than UB
+			if (norm == 0 || best_one_tree_cost > UB)
 			{
-				best_zero_tree_cost = zero_tree_cost;
-				best_zero_tree = zero_tree;
+				if (shared)
+					shared->done = true;
+
+				break;
+			}
 
-				t_1 = 0.01f * zero_tree_cost;
+			if (shared && k % Exchange == 0)
+			{
+				lock_guard<mutex> guard(shared->lock);
 
-				if (zero_tree_cost > UB)
+				if (shared->done)
 					break;
+
+				if (best_one_tree_cost > shared->bound)
+				{
+					shared->bound = best_one_tree_cost;
+					shared->oneTree = best_one_tree;
+					shared->λ = best_λ;
+				}
+				else if (shared->bound > best_one_tree_cost)
+				{
+					λ = shared->λ;
+					continue;
+				}
 			}
 
-			if (zero_tree->HaveCycle())
-				break;
+			if (schedule == Schedule::VolgenantJonker)
+			{
+				t_k = t_1 * ((k * k - 3.0f * (M - 1.0f) * k + constraint2) / constraint1);
 
-			t_k = t_1 * ((k * k - 3.0f * (M - 1.0f) * k + constraint2) / constraint1);
+				for (unsigned short i = 0; i < numberOfNodes; i++)
+					λ[i] += 0.6f * t_k * (d_k[i] - 2) + 0.4f * t_k * (d_k_prev[i] - 2);
 
-			for (auto i : zero_tree->V)
-				π[i->id] += 0.6f * t_k * (2 - d_k[i->id]) + 0.4f * t_k * (2 - d_k_prev[i->id]);
+				swap(d_k, d_k_prev);
+			}
+			else
+			{
+				if (schedule == Schedule::HeldWolfeCrowder && k % period == 0)
+					α /= 2;
 
-			d_k_prev.clear();
-			for (auto d : d_k)
-				d_k_prev[d.first] = d.second;
+				t_k = α * (UB - one_tree_cost) / norm;
+
+				for (unsigned short i = 0; i < numberOfNodes; i++)
+					λ[i] += t_k * (d_k[i] - 2);
+			}
 
-			for (auto e : G.E)
-				e->cost = distance[e->from->id][e->to->id] - π[e->from->id] - π[e->to->id];
+			if (trace)
+				trace->Record(names[static_cast<int>(schedule)], ascent, k, one_tree_cost, t_k, sqrt(norm), violations);
 		}
 
-		return best_zero_tree;
+		if (shared)
+		{
+			lock_guard<mutex> guard(shared->lock);
+
+			if (best_one_tree_cost > shared->bound)
+			{
+				shared->bound = best_one_tree_cost;
+				shared->oneTree = best_one_tree;
+				shared->λ = best_λ;
+			}
+		}
+
+		return best_one_tree_cost;
+	}
+
+	// the three schedules on concurrent threads, sharing the best λ
+	float LagrangianRelaxation::Portfolio(sTree &best_one_tree, vector<float> &best_λ)
+	{
+		sPortfolio P(numberOfNodes);
+		vector<thread> threads;
+
+		for (auto schedule : { Schedule::VolgenantJonker, Schedule::HeldWolfeCrowder, Schedule::Polyak })
+			threads.push_back(thread([this, schedule, &P]
+			{
+				sTree T(numberOfNodes);
+				vector<float> λ;
+
+				LagrangeSubGradient(schedule, T, λ, &P);
+			}));
+
+		for (auto &t : threads)
+			t.join();
+
+		best_one_tree = P.oneTree;
+		best_λ = P.λ;
+
+		return P.bound;
+	}
+
+	/*
+	Tour from the best 1-tree: its edges are kept cheapest first while they leave every degree at most 2 and close no cycle,
+	then the fragments are joined greedily on the λ-adjusted costs of their endpoints.
+	*/
+	vector<unsigned short> LagrangianRelaxation::Patch(sTree &oneTree, const vector<float> &λ) // O(V² ㏒ V)
+	{
+		const auto n = numberOfNodes;
+
+		auto w = [&](unsigned short i, unsigned short j)
+		{
+			return distance[i][j] + λ[i] + λ[j];
+		};
+
+		vector<unsigned short> degree(n, 0), parent(n);
+		vector<vector<unsigned short>> adj(n);
+		unsigned short edges = 0;
+
+		for (unsigned short i = 0; i < n; i++)
+			parent[i] = i;
+
+		auto find = [&](unsigned short v)
+		{
+			while (parent[v] != v)
+				v = parent[v] = parent[parent[v]];
+
+			return v;
+		};
+
+		auto add = [&](sEdge e)
+		{
+			auto a = find(e.from);
+			auto b = find(e.to);
+
+			if (degree[e.from] < 2 && degree[e.to] < 2 && a != b && edges < n - 1)
+			{
+				parent[a] = b;
+				degree[e.from]++;
+				degree[e.to]++;
+				adj[e.from].push_back(e.to);
+				adj[e.to].push_back(e.from);
+				edges++;
+			}
+		};
+
+		auto cheaper = [&](sEdge l, sEdge r)
+		{
+			return w(l.from, l.to) < w(r.from, r.to);
+		};
+
+		vector<sEdge> E(oneTree.T);
+		sort(E.begin(), E.end(), cheaper);
+
+		for (auto e : E)
+			add(e);
+
+		// join the endpoints of the fragments
+		vector<unsigned short> ends;
+
+		for (unsigned short v = 0; v < n; v++)
+			if (degree[v] < 2)
+				ends.push_back(v);
+
+		E.clear();
+
+		for (unsigned short a = 0; a < ends.size(); a++)
+			for (unsigned short b = a + 1; b < ends.size(); b++)
+				E.push_back(sEdge(ends[a], ends[b]));
+
+		sort(E.begin(), E.end(), cheaper);
+
+		for (auto e : E)
+			add(e);
+
+		// walk the Hamiltonian path from one of its ends
+		vector<unsigned short> tour;
+		unsigned short p = n, v = ends[0];
+
+		for (auto e : ends)
+			if (degree[e] < 2)
+			{
+				v = e;
+				break;
+			}
+
+		while (tour.size() < n)
+		{
+			tour.push_back(v);
+
+			for (auto u : adj[v])
+				if (u != p)
+				{
+					p = v;
+					v = u;
+					break;
+				}
+		}
+
+		return tour;
 	}
 
 	/*
 	From: Volgenant, T. and Jonker, R., 1982. A branch and bound algorithm for the symmetric traveling salesman problem based on the 1-tree relaxation. European Journal of Operational Research, 9(1):83–89.
 	*/
+	void LagrangianRelaxation::Ascent()
+	{
+		UB = UpperBound();
+		LB = (portfolio ? Portfolio(oneTree, λ) : LagrangeSubGradient(Schedule::VolgenantJonker, oneTree, λ));
+	}
+
+	/*
+	α(i, j) is the increase of the best 1-tree when the edge (i, j) is forced in: w[i][j] minus the dearest edge on the tree path i..j,
+	minus the dearest edge at 0 when i = 0. Rows are scanned in the order Prim added the nodes, so β of a parent is ready before its children:
+	O(V²) time and O(V) memory besides the k best of each row.
+	From: Helsgaun, K., 2000. An effective implementation of the Lin–Kernighan traveling salesman heuristic. European Journal of Operational Research, 126(1):106–130.
+	*/
+	vector<vector<unsigned short>> LagrangianRelaxation::AlphaCandidates(unsigned short k)
+	{
+		if (λ.empty())
+			Ascent();
+
+		const auto n = numberOfNodes;
+
+		k = min<unsigned short>(k, n - 1);
+
+		auto w = [&](unsigned short i, unsigned short j)
+		{
+			return distance[i][j] + λ[i] + λ[j];
+		};
+
+		// the tree on 1..n-1 is rooted at 1, oneTree[j] joins the (j+2)-th node added to its parent
+		vector<unsigned short> order(1, 1), dad(n, n), mark(n, n);
+		vector<float> β(n);
+
+		for (unsigned short j = 0; j < n - 2; j++)
+		{
+			order.push_back(oneTree[j].from);
+			dad[oneTree[j].from] = oneTree[j].to;
+		}
+
+		auto e1 = oneTree[n - 2].to;
+		auto e2 = oneTree[n - 1].to;
+		auto max0 = max(w(0, e1), w(0, e2));
+
+		vector<vector<unsigned short>> candidates(n);
+		vector<pair<float, unsigned short>> row;
+
+		auto keep = [&](unsigned short i)
+		{
+			auto last = row.begin() + min<size_t>(k, row.size());
+
+			partial_sort(row.begin(), last, row.end());
+
+			for (auto it = row.begin(); it != last; it++)
+				candidates[i].push_back(it->second);
+
+			row.clear();
+		};
+
+		for (unsigned short j = 1; j < n; j++)
+			row.push_back(make_pair((j == e1 || j == e2 ? 0 : w(0, j) - max0), j));
+
+		keep(0);
+
+		for (auto i : order)
+		{
+			β[i] = -FLT_MAX;
+			mark[i] = i;
+
+			// path from i to the root
+			for (auto v = i; dad[v] < n; v = dad[v])
+			{
+				β[dad[v]] = max(β[v], w(v, dad[v]));
+				mark[dad[v]] = i;
+			}
+
+			for (auto j : order)
+				if (j != i)
+				{
+					if (mark[j] != i)
+						β[j] = max(β[dad[j]], w(j, dad[j]));
+
+					row.push_back(make_pair(w(i, j) - β[j], j));
+				}
+
+			row.push_back(make_pair((i == e1 || i == e2 ? 0 : w(0, i) - max0), 0));
+
+			keep(i);
+		}
+
+		return candidates;
+	}
+
 	void LagrangianRelaxation::Solve(float &opt, string &path)
 	{
-		Graph G(numberOfNodes);
-		G.MakeConnected(distance);
+		Ascent();
 
-		UB = UpperBound();
+		auto tour = Patch(oneTree, λ);
+
+		// the α-nearness lists hold the tour edges far better than the nearest neighbours
+		LocalSearch<> localSearch(distance);
+		localSearch.SetCandidates(AlphaCandidates(5));
+		localSearch.LinKernighan(tour, 0);
 
-		auto LB = 0.0f;
-		auto zero_tree = LagrangeSubGradient(G, LB);
+		UB = localSearch.Cost(tour);
 
-		opt = LB;
-		path = PrintPath();
+		opt = UB;
+		path = PrintPath(tour);
 	}
 
 }
\ No newline at end of file
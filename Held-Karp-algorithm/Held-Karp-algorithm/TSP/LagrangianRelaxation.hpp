@@ -6,11 +6,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 #pragma once
 
-#include <memory>
-#include <map>
+#include <atomic>
+#include <mutex>
 #include <vector>
 
-#include "../ADS/Graph.hpp"
+#include "../ADS/sGraph.hpp"
+#include "../MST/Prim.hpp"
+#include "AscentTrace.hpp"
 #include "Base/TSP.hpp"
 
 using namespace std;
@@ -20,21 +22,71 @@ namespace TSP
 {
 	class LagrangianRelaxation : public Base::TSP
 	{
+	public:
+		// step size rule of the subgradient ascent
+		enum class Schedule
+		{
+			VolgenantJonker,
+			HeldWolfeCrowder,
+			Polyak
+		};
+
 	private:
+		// best multipliers shared by the schedules of the portfolio
+		struct sPortfolio
+		{
+			mutex lock;
+			atomic<bool> done;
+			float bound = -FLT_MAX;
+			vector<float> λ;
+			sTree oneTree;
+
+			sPortfolio(unsigned short size) : done(false), λ(size, 0), oneTree(size) {}
+		};
+
+	private:
+		const bool portfolio;
+
+		// off when null
+		AscentTrace *trace = nullptr;
+
 		float UB;
+		float LB = 0;
+
+		// best 1-tree of the ascent and its multipliers
+		sTree oneTree;
+		vector<float> λ;
 
 	private:
 		float UpperBound();
 
-		shared_ptr<Graph> LagrangeSubGradient(Graph &G, float &best_zero_tree_cost);
+		void OneTree(sTree &T, MST::sDenseWorkspace &W, const vector<float> &λ);
+		float LagrangeSubGradient(Schedule schedule, sTree &best_one_tree, vector<float> &best_λ, sPortfolio *shared = nullptr);
+		float Portfolio(sTree &best_one_tree, vector<float> &best_λ);
+
+		vector<unsigned short> Patch(sTree &oneTree, const vector<float> &λ);
+
+		void Ascent();
 
 	protected:
-		string PrintPath();
+		string PrintPath(const vector<unsigned short> &tour);
+		string Report();
 
 		void Solve(float &opt, string &path);
 
 	public:
-		LagrangianRelaxation(const vector<vector<float>> &DistanceMatrix2D);
+		// with portfolio the schedules run on concurrent threads and the highest bound wins
+		LagrangianRelaxation(const vector<vector<float>> &DistanceMatrix2D, bool portfolio = false);
+
+		// bound of the last Solve, and the gap of its tour above it
+		float LowerBound();
+		float Gap();
+
+		// the k edges of each node with the least α-nearness on the best 1-tree, running the ascent if Solve did not
+		vector<vector<unsigned short>> AlphaCandidates(unsigned short k);
+
+		// every iteration of the ascent is written to trace, null to stop
+		void SetTrace(AscentTrace *trace);
 
 	};
 }
\ No newline at end of file
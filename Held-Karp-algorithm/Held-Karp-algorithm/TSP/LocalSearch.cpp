@@ -0,0 +1,536 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+2-opt
+From: Croes, G. A., 1958. A method for solving traveling-salesman problems. Operations Research, 6(6):791–812.
+
+Or-opt
+From: Or, I., 1976. Traveling salesman-type combinatorial problems and their relation to the logistics of regional blood banking. Ph.D. thesis, Northwestern University.
+
+Neighbour lists and don't-look bits
+From: Bentley, J. L., 1992. Fast algorithms for geometric traveling salesman problems. ORSA Journal on Computing, 4(4):387–411.
+
+Lin–Kernighan as a chain of 2-opt moves, iterated with double-bridge kicks
+From: Lin, S. and Kernighan, B. W., 1973. An effective heuristic algorithm for the traveling-salesman problem. Operations Research, 21(2):498–516.
+From: Johnson, D. S. and McGeoch, L. A., 1997. The traveling salesman problem: a case study in local optimization. Local Search in Combinatorial Optimization, 215–310.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+
+#include "LocalSearch.hpp"
+
+namespace TSP
+{
+	template <class Tour>
+	LocalSearch<Tour>::LocalSearch(const vector<vector<float>> &DistanceMatrix2D, unsigned short neighbours) :
+		distance(DistanceMatrix2D),
+		k(neighbours) {}
+
+	template <class Tour>
+	void LocalSearch<Tour>::SetCandidates(const vector<vector<unsigned short>> &candidates)
+	{
+		this->candidates = candidates;
+	}
+
+	// k nearest neighbours of each node, built on first use
+	template <class Tour>
+	void LocalSearch<Tour>::Neighbours() // O(V² ㏒ k)
+	{
+		const unsigned short n = distance.size();
+		const unsigned short K = min<unsigned short>(k, n - 1);
+
+		vector<unsigned short> row;
+		candidates.assign(n, {});
+
+		for (unsigned short i = 0; i < n; i++)
+		{
+			row.clear();
+
+			for (unsigned short j = 0; j < n; j++)
+				if (j != i)
+					row.push_back(j);
+
+			partial_sort(row.begin(), row.begin() + K, row.end(), [&](unsigned short l, unsigned short r)
+			{
+				return distance[i][l] < distance[i][r];
+			});
+
+			candidates[i].assign(row.begin(), row.begin() + K);
+		}
+	}
+
+	// tour is the sequence of the nodes, the edge back to the first node is implicit
+	template <class Tour>
+	float LocalSearch<Tour>::Cost(const vector<unsigned short> &tour) // O(V)
+	{
+		float cost = 0;
+
+		for (size_t i = 0; i < tour.size(); i++)
+			cost += distance[tour[i]][tour[(i + 1) % tour.size()]];
+
+		return cost;
+	}
+
+	template <class Tour>
+	unsigned short LocalSearch<Tour>::Succ(unsigned short v)
+	{
+		return tour.Next(v);
+	}
+
+	template <class Tour>
+	unsigned short LocalSearch<Tour>::Pred(unsigned short v)
+	{
+		return tour.Prev(v);
+	}
+
+	template <class Tour>
+	unsigned short LocalSearch<Tour>::Next(unsigned short v, bool forward)
+	{
+		return forward ? Succ(v) : Pred(v);
+	}
+
+	template <class Tour>
+	void LocalSearch<Tour>::Push(unsigned short v)
+	{
+		if (!queued[v])
+		{
+			queued[v] = true;
+			queue.push_back(v);
+		}
+	}
+
+	// 2-opt move: the tour edges (a, b), (c, d), with b and d on the same side of a and c, become (a, c), (b, d)
+	template <class Tour>
+	void LocalSearch<Tour>::Flip(unsigned short a, unsigned short b, unsigned short c, unsigned short d)
+	{
+		if (Succ(a) == b)
+			tour.Reverse(b, c);
+		else
+			tour.Reverse(a, d);
+
+		length += (double)distance[a][c] + distance[b][d] - distance[a][b] - distance[c][d];
+
+		if (journaling)
+			journal.push_back({ a, b, c, d });
+	}
+
+	// Flip, and the four nodes are tried again
+	template <class Tour>
+	void LocalSearch<Tour>::Move(unsigned short a, unsigned short b, unsigned short c, unsigned short d)
+	{
+		Flip(a, b, c, d);
+
+		Push(a);
+		Push(b);
+		Push(c);
+		Push(d);
+	}
+
+	// first improving 2-opt move that joins a to one of its candidates
+	template <class Tour>
+	bool LocalSearch<Tour>::TwoOptMove(unsigned short a)
+	{
+		for (auto forward : { true, false })
+		{
+			auto b = Next(a, forward);
+			auto ab = distance[a][b];
+
+			for (auto c : candidates[a])
+			{
+				auto g = ab - distance[a][c];
+
+				if (g <= ε)
+					break;
+
+				auto d = Next(c, forward);
+
+				if (c == b || d == a)
+					continue;
+
+				if (g + distance[c][d] - distance[b][d] > ε)
+				{
+					Move(a, b, c, d);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/*
+	First improving Or-opt move of a segment of 1..3 nodes that starts at a: the segment s1..s2 between p and x
+	is inserted, straight or reversed, in the edge (c, e) of a candidate c of a.
+	Done as three 2-opt moves on p s1..s2 x..c e: (p, c)(s1, e), then (p, x)(c, s2), then (c, s1)(s2, e) if straight.
+	*/
+	template <class Tour>
+	bool LocalSearch<Tour>::OrOptMove(unsigned short a)
+	{
+		const size_t n = tour.size();
+
+		for (size_t L = 1; L <= 3 && L + 4 <= n; L++)
+			for (auto forward : { true, false })
+			{
+				unsigned short segment[3] = { a, a, a };
+
+				for (unsigned short s = 1; s < L; s++)
+					segment[s] = Next(segment[s - 1], forward);
+
+				auto s1 = a;
+				auto s2 = segment[L - 1];
+				auto p = Next(s1, !forward);
+				auto x = Next(s2, forward);
+
+				auto g = distance[p][s1] + distance[s2][x] - distance[p][x];
+
+				if (g <= ε)
+					continue;
+
+				for (auto c : candidates[s1])
+				{
+					if (distance[s1][c] >= g - ε)
+						break;
+
+					if (c == segment[0] || c == segment[1] || c == segment[2])
+						continue;
+
+					// straight: c s1..s2 e, with e after c
+					if (c != p)
+					{
+						auto e = Next(c, forward);
+
+						if (g - distance[c][s1] - distance[s2][e] + distance[c][e] > ε)
+						{
+							Move(p, s1, c, e);
+
+							if (c != x)
+								Move(p, c, x, s2);
+
+							if (L > 1)
+								Move(c, s2, s1, e);
+
+							return true;
+						}
+					}
+
+					// reversed: e s2..s1 c, with e before c
+					if (c != x)
+					{
+						auto e = Next(c, !forward);
+
+						if (g - distance[e][s2] - distance[s1][c] + distance[e][c] > ε)
+						{
+							Move(p, s1, e, c);
+
+							if (e != x)
+								Move(p, e, x, s2);
+
+							return true;
+						}
+					}
+				}
+			}
+
+		return false;
+	}
+
+	/*
+	Lin–Kernighan move from t1: remove (t1, t2), add (t2, t3), remove (t3, t4), and close with (t4, t1) as a 2-opt move;
+	while the partial gain stays positive the chain goes on from t4 in place of t2, up to Depth moves.
+	Every candidate t3 is tried at the first level, the best one by d(t3, t4) − d(t2, t3) at the deeper ones.
+	An edge added by the chain is never removed and a removed one is never added back.
+	The chain is cut at its best closed tour, or undone.
+	*/
+	template <class Tour>
+	bool LocalSearch<Tour>::LinKernighanMove(unsigned short t1)
+	{
+		auto added = [&](unsigned short u, unsigned short v)
+		{
+			for (auto &f : flips)
+				if ((f[0] == u && f[2] == v) || (f[0] == v && f[2] == u))
+					return true;
+
+			return false;
+		};
+
+		auto removed = [&](unsigned short u, unsigned short v)
+		{
+			for (auto &f : flips)
+				if ((f[0] == u && f[1] == v) || (f[0] == v && f[1] == u) || (f[2] == u && f[3] == v) || (f[2] == v && f[3] == u))
+					return true;
+
+			return false;
+		};
+
+		for (auto forward : { true, false })
+		{
+			const auto t2 = Next(t1, forward);
+			const auto g1 = distance[t1][t2];
+
+			for (auto t3 : candidates[t2])
+			{
+				if (g1 - distance[t2][t3] <= ε)
+					break;
+
+				auto t4 = Next(t3, Succ(t2) == t1);
+
+				if (t3 == t1 || t4 == t2)
+					continue;
+
+				flips.clear();
+				flips.push_back({ t2, t1, t3, t4 });
+				Flip(t2, t1, t3, t4);
+
+				auto g = g1 - distance[t2][t3] + distance[t3][t4];
+				auto last = t4;
+				auto best = g - distance[last][t1];
+				size_t kept = 1;
+
+				while (flips.size() < Depth)
+				{
+					unsigned short t5 = last, t6 = last;
+					auto value = -FLT_MAX;
+
+					for (auto c : candidates[last])
+					{
+						auto gc = g - distance[last][c];
+
+						if (gc <= ε)
+							break;
+
+						auto d = Next(c, Succ(last) == t1);
+
+						if (c == t1 || d == last || added(c, d) || removed(last, c))
+							continue;
+
+						if (gc + distance[c][d] > value)
+						{
+							value = gc + distance[c][d];
+							t5 = c;
+							t6 = d;
+						}
+					}
+
+					if (t5 == last)
+						break;
+
+					flips.push_back({ last, t1, t5, t6 });
+					Flip(last, t1, t5, t6);
+
+					g = value;
+					last = t6;
+
+					if (g - distance[last][t1] > best)
+					{
+						best = g - distance[last][t1];
+						kept = flips.size();
+					}
+				}
+
+				if (best <= ε)
+					kept = 0;
+
+				// undo the moves after the best closed tour: (a, c), (b, d) back to (a, b), (c, d)
+				while (flips.size() > kept)
+				{
+					auto &f = flips.back();
+					Flip(f[0], f[2], f[1], f[3]);
+					flips.pop_back();
+				}
+
+				if (kept > 0)
+				{
+					for (auto &f : flips)
+						for (auto v : f)
+							Push(v);
+
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/*
+	The three paths after a random node are exchanged: A B C D becomes A C B D, cutting three edges near each other.
+	Done as three 2-opt moves: A C^r B^r D, A C B^r D, A C B D.
+	*/
+	template <class Tour>
+	void LocalSearch<Tour>::DoubleBridge(mt19937 &random)
+	{
+		const size_t n = tour.size();
+		const size_t W = min<size_t>(n, KickWindow);
+
+		uniform_int_distribution<size_t> node(0, n - 1), cut(1, W - 1);
+
+		size_t i, j, h;
+		do
+		{
+			i = cut(random);
+			j = cut(random);
+			h = cut(random);
+
+			if (i > j) swap(i, j);
+			if (j > h) swap(j, h);
+			if (i > j) swap(i, j);
+		} while (i == j || j == h);
+
+		vector<unsigned short> window(1, node(random));
+
+		while (window.size() < W)
+			window.push_back(Succ(window.back()));
+
+		auto a = window[i - 1], b1 = window[i], b2 = window[j - 1], c1 = window[j], c2 = window[h - 1], d = window[h];
+
+		Move(a, b1, c2, d);
+		Move(a, c2, c1, b2);
+		Move(c2, b2, b1, d);
+	}
+
+	template <class Tour>
+	void LocalSearch<Tour>::Load(const vector<unsigned short> &tour)
+	{
+		if (candidates.empty())
+			Neighbours();
+
+		this->tour.Load(tour);
+		queued.assign(distance.size(), false);
+		queue.clear();
+
+		for (auto v : tour)
+			Push(v);
+
+		length = Cost();
+	}
+
+	// length of the tour under improvement
+	template <class Tour>
+	float LocalSearch<Tour>::Cost() // O(V)
+	{
+		float cost = 0;
+		unsigned short v = 0;
+
+		for (size_t i = 0; i < tour.size(); i++)
+		{
+			cost += distance[v][Succ(v)];
+			v = Succ(v);
+		}
+
+		return cost;
+	}
+
+	// moves from the queued nodes until none improves
+	template <class Tour>
+	void LocalSearch<Tour>::Descent(bool orOpt, bool linKernighan) // O(V·k) per pass, plus the reversals
+	{
+		while (!queue.empty())
+		{
+			auto a = queue.front();
+			queue.pop_front();
+			queued[a] = false;
+
+			while (TwoOptMove(a) || (orOpt && OrOptMove(a)) || (linKernighan && LinKernighanMove(a)));
+		}
+	}
+
+	template <class Tour>
+	float LocalSearch<Tour>::Run(vector<unsigned short> &tour, bool orOpt)
+	{
+		if (tour.size() < 5)
+			return Cost(tour);
+
+		Load(tour);
+		Descent(orOpt, false);
+		this->tour.Store(tour);
+
+		return Cost(tour);
+	}
+
+	// 2-opt on the candidate lists, until no move joining a node to a candidate shortens the tour
+	template <class Tour>
+	float LocalSearch<Tour>::TwoOpt(vector<unsigned short> &tour)
+	{
+		return Run(tour, false);
+	}
+
+	// 2-opt and Or-opt on the candidate lists
+	template <class Tour>
+	float LocalSearch<Tour>::Improve(vector<unsigned short> &tour)
+	{
+		return Run(tour, true);
+	}
+
+	// a kicked tour that is not shorter after the descent is thrown away
+	template <class Tour>
+	float LocalSearch<Tour>::LinKernighan(vector<unsigned short> &tour, float seconds, unsigned int seed)
+	{
+		const auto n = tour.size();
+
+		if (n < 8)
+			return Improve(tour);
+
+		const auto end = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<float>(seconds));
+
+		Load(tour);
+		Descent(true, true);
+
+		auto best = length;
+		mt19937 random(seed);
+
+		// the tour under improvement is always the best one: the moves of a rejected kick are undone from the journal
+		journaling = true;
+
+		while (chrono::steady_clock::now() < end)
+		{
+			journal.clear();
+
+			DoubleBridge(random);
+			Descent(true, true);
+
+			if (length < best - ε)
+			{
+				best = length;
+			}
+			else
+			{
+				journaling = false;
+
+				for (auto f = journal.rbegin(); f != journal.rend(); f++)
+					Flip((*f)[0], (*f)[2], (*f)[1], (*f)[3]);
+
+				journaling = true;
+				length = best;
+			}
+		}
+
+		journaling = false;
+		this->tour.Store(tour);
+
+		return Cost(tour);
+	}
+
+	template class LocalSearch<ADS::ArrayTour>;
+	template class LocalSearch<ADS::TwoLevelList>;
+
+	float ImproveTour(const vector<vector<float>> &distance, vector<unsigned short> &tour, float seconds)
+	{
+		if (tour.size() < TwoLevelListFrom)
+		{
+			LocalSearch<ADS::ArrayTour> localSearch(distance);
+			return (seconds > 0 ? localSearch.LinKernighan(tour, seconds) : localSearch.Improve(tour));
+		}
+		else
+		{
+			LocalSearch<ADS::TwoLevelList> localSearch(distance);
+			return (seconds > 0 ? localSearch.LinKernighan(tour, seconds) : localSearch.Improve(tour));
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <array>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "../ADS/ArrayTour.hpp"
+#include "../ADS/TwoLevelList.hpp"
+
+using namespace std;
+
+namespace TSP
+{
+	// tours from this size on are improved on the two-level list
+	constexpr size_t TwoLevelListFrom = 10000;
+
+	// Improvement of a tour of the symmetric TSP, post-processing stage of the solvers; Tour is ADS::ArrayTour or ADS::TwoLevelList
+	template <class Tour = ADS::ArrayTour>
+	class LocalSearch
+	{
+	private:
+		// minimum gain of a move, against rounding loops
+		static constexpr float ε = 1e-4f;
+
+		// maximum number of 2-opt moves chained by a Lin–Kernighan move
+		static constexpr unsigned short Depth = 5;
+
+		// edges of a double-bridge kick are cut in a window of this many nodes
+		static constexpr unsigned short KickWindow = 50;
+
+		const vector<vector<float>> &distance;
+		const unsigned short k;
+
+		// candidate neighbours of each node, nearest first
+		vector<vector<unsigned short>> candidates;
+
+		// tour under improvement and its length
+		Tour tour;
+		double length;
+
+		// 2-opt moves since the last kick, to undo it
+		vector<array<unsigned short, 4>> journal;
+		bool journaling = false;
+
+		// don't-look bits: only the queued nodes are tried again
+		deque<unsigned short> queue;
+		vector<bool> queued;
+
+		// 2-opt moves of the Lin–Kernighan move under construction
+		vector<array<unsigned short, 4>> flips;
+
+	private:
+		void Neighbours();
+
+		unsigned short Succ(unsigned short v);
+		unsigned short Pred(unsigned short v);
+		unsigned short Next(unsigned short v, bool forward);
+
+		void Push(unsigned short v);
+		void Flip(unsigned short a, unsigned short b, unsigned short c, unsigned short d);
+		void Move(unsigned short a, unsigned short b, unsigned short c, unsigned short d);
+
+		bool TwoOptMove(unsigned short a);
+		bool OrOptMove(unsigned short a);
+		bool LinKernighanMove(unsigned short t1);
+		void DoubleBridge(mt19937 &random);
+
+		void Load(const vector<unsigned short> &tour);
+		float Cost();
+
+		void Descent(bool orOpt, bool linKernighan);
+		float Run(vector<unsigned short> &tour, bool orOpt);
+
+	public:
+		LocalSearch(const vector<vector<float>> &DistanceMatrix2D, unsigned short neighbours = 10);
+
+		// replace the k-nearest lists, e.g. with α-nearness candidates
+		void SetCandidates(const vector<vector<unsigned short>> &candidates);
+
+		float Cost(const vector<unsigned short> &tour);
+
+		float TwoOpt(vector<unsigned short> &tour);
+		float Improve(vector<unsigned short> &tour);
+
+		// Lin–Kernighan descent, then double-bridge kicks until seconds have passed
+		float LinKernighan(vector<unsigned short> &tour, float seconds, unsigned int seed = 1);
+
+	};
+
+	// 2-opt and Or-opt, or iterated Lin–Kernighan for seconds > 0, on the tour structure suited to the size
+	float ImproveTour(const vector<vector<float>> &distance, vector<unsigned short> &tour, float seconds = 0);
+}
\ No newline at end of file
@@ -0,0 +1,211 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <sstream>
+
+#include "Statistics.hpp"
+
+namespace TSP
+{
+	Statistics::Statistics()
+	{
+		Reset();
+	}
+
+	void Statistics::Reset()
+	{
+		nodesCreated = 0;
+		nodesPruned = 0;
+		nodesExpanded = 0;
+		nodesTour = 0;
+		nodesFinished = 0;
+		boundCalls = 0;
+		ascentIterations = 0;
+		primNanoseconds = 0;
+		edgesEliminated = 0;
+
+		for (auto &h : ascentHistogram)
+			h = 0;
+
+		begin = steady_clock::now();
+		lastSample = -1000;
+
+		lock_guard<mutex> guard(lock);
+		openListSamples.clear();
+		incumbents.clear();
+	}
+
+	long long Statistics::Elapsed()
+	{
+		return duration_cast<milliseconds>(steady_clock::now() - begin).count();
+	}
+
+	void Statistics::Ascent(unsigned short iterations)
+	{
+		unsigned short bin = 0;
+
+		while (bin + 1 < HistogramBins && (iterations >> (bin + 1)) > 0)
+			bin++;
+
+		boundCalls++;
+		ascentIterations += iterations;
+		ascentHistogram[bin]++;
+	}
+
+	// sampled at most every 100ms
+	void Statistics::OpenList(size_t size)
+	{
+		auto now = Elapsed();
+		auto last = lastSample.load();
+
+		if (now - last >= 100 && lastSample.compare_exchange_strong(last, now))
+		{
+			lock_guard<mutex> guard(lock);
+			openListSamples.push_back(make_pair(now, size));
+		}
+	}
+
+	void Statistics::Incumbent(float cost)
+	{
+		auto now = Elapsed();
+
+		lock_guard<mutex> guard(lock);
+		incumbents.push_back(make_pair(now, cost));
+	}
+
+	string Statistics::Line()
+	{
+		stringstream ss;
+		size_t open = 0;
+		float UB = 0;
+
+		{
+			lock_guard<mutex> guard(lock);
+
+			if (!openListSamples.empty())
+				open = openListSamples.back().second;
+
+			if (!incumbents.empty())
+				UB = incumbents.back().second;
+		}
+
+		ss
+			<< " nodes: " << nodesCreated
+			<< " expanded: " << nodesExpanded
+			<< " pruned: " << nodesPruned
+			<< " open: " << open
+			<< " UB: " << UB
+			<< " ET: " << Elapsed() / 1000 << "s";
+
+		return ss.str();
+	}
+
+	string Statistics::ToJSON()
+	{
+		stringstream ss;
+
+		ss
+			<< "{" << endl
+			<< "\t\"elapsed_ms\": " << Elapsed() << "," << endl
+			<< "\t\"nodes_created\": " << nodesCreated << "," << endl
+			<< "\t\"nodes_pruned\": " << nodesPruned << "," << endl
+			<< "\t\"nodes_expanded\": " << nodesExpanded << "," << endl
+			<< "\t\"nodes_tour\": " << nodesTour << "," << endl
+			<< "\t\"nodes_finished\": " << nodesFinished << "," << endl
+			<< "\t\"edges_eliminated\": " << edgesEliminated << "," << endl
+			<< "\t\"bound_calls\": " << boundCalls << "," << endl
+			<< "\t\"ascent_iterations\": " << ascentIterations << "," << endl
+			<< "\t\"prim_ms\": " << primNanoseconds / 1000000 << "," << endl
+			<< "\t\"ascent_histogram\": [";
+
+		for (unsigned short k = 0; k < HistogramBins; k++)
+			ss << (k > 0 ? ", " : "") << ascentHistogram[k];
+
+		ss << "]," << endl;
+
+		lock_guard<mutex> guard(lock);
+
+		ss << "\t\"open_list\": [";
+
+		for (size_t k = 0; k < openListSamples.size(); k++)
+			ss << (k > 0 ? ", " : "") << "[" << openListSamples[k].first << ", " << openListSamples[k].second << "]";
+
+		ss << "]," << endl << "\t\"incumbents\": [";
+
+		for (size_t k = 0; k < incumbents.size(); k++)
+			ss << (k > 0 ? ", " : "") << "[" << incumbents[k].first << ", " << incumbents[k].second << "]";
+
+		ss << "]" << endl << "}" << endl;
+
+		return ss.str();
+	}
+
+	void Statistics::Save(BinaryWriter &out)
+	{
+		out.I64(Elapsed());
+
+		for (auto c : { &nodesCreated, &nodesPruned, &nodesExpanded, &nodesTour, &nodesFinished, &boundCalls, &ascentIterations, &edgesEliminated })
+			out.U64(c->load());
+
+		out.I64(primNanoseconds);
+
+		for (auto &h : ascentHistogram)
+			out.U64(h.load());
+
+		lock_guard<mutex> guard(lock);
+
+		out.U64(openListSamples.size());
+
+		for (auto &s : openListSamples)
+		{
+			out.I64(s.first);
+			out.U64(s.second);
+		}
+
+		out.U64(incumbents.size());
+
+		for (auto &i : incumbents)
+		{
+			out.I64(i.first);
+			out.F32(i.second);
+		}
+	}
+
+	void Statistics::Load(BinaryReader &in)
+	{
+		begin = steady_clock::now() - milliseconds(in.I64());
+
+		for (auto c : { &nodesCreated, &nodesPruned, &nodesExpanded, &nodesTour, &nodesFinished, &boundCalls, &ascentIterations, &edgesEliminated })
+			*c = in.U64();
+
+		primNanoseconds = in.I64();
+
+		for (auto &h : ascentHistogram)
+			h = in.U64();
+
+		lock_guard<mutex> guard(lock);
+
+		// a damaged count fails the stream instead of allocating for it
+		openListSamples.resize(in.Count(16));
+
+		for (auto &s : openListSamples)
+		{
+			s.first = in.I64();
+			s.second = in.U64();
+		}
+
+		incumbents.resize(in.Count(12));
+
+		for (auto &i : incumbents)
+		{
+			i.first = in.I64();
+			i.second = in.F32();
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+﻿/*
+MIT License
+Copyright (c) 2020: Michele Maione
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions: The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BinaryIO.hpp"
+
+using namespace std;
+using namespace chrono;
+
+namespace TSP
+{
+	// Counters of a branch-and-bound search, updated by the workers and readable while they run
+	class Statistics
+	{
+	public:
+		static const unsigned short HistogramBins = 16;
+
+		atomic<size_t> nodesCreated, nodesPruned, nodesExpanded, nodesTour, nodesFinished;
+		atomic<size_t> boundCalls, ascentIterations;
+		atomic<long long> primNanoseconds;
+		atomic<size_t> edgesEliminated;
+
+		// ascents by number of iterations, bin k counts [2^k, 2^(k+1))
+		atomic<size_t> ascentHistogram[HistogramBins];
+
+	private:
+		time_point<steady_clock> begin;
+		atomic<long long> lastSample;
+
+		mutex lock;
+		vector<pair<long long, size_t>> openListSamples; // <ms, open nodes>
+		vector<pair<long long, float>> incumbents; // <ms, cost>
+
+	public:
+		Statistics();
+
+		void Reset();
+
+		long long Elapsed();
+
+		void Ascent(unsigned short iterations);
+		void OpenList(size_t size);
+		void Incumbent(float cost);
+
+		string Line();
+		string ToJSON();
+
+		// binary image of the counters, Load continues the clock from the saved elapsed time
+		void Save(BinaryWriter &out);
+		void Load(BinaryReader &in);
+
+	};
+}
\ No newline at end of file
@@ -8,6 +8,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <fstream>
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 #include "TSP/ApproxTSP.hpp"
@@ -20,6 +22,108 @@ using namespace TSP;
 using namespace std;
 using namespace std::experimental;
 
+// options following the positional parameters, each used by the algorithms that have it
+struct sOptions
+{
+	unsigned short threads = 0;
+	Branch_and_Bound::WarmStart warmStart = Branch_and_Bound::WarmStart::Christofides;
+	string checkpointFile;
+	unsigned int checkpointInterval = 60;
+	string statisticsFile;
+	string traceFile;
+	bool portfolio = false;
+	Christofides::MatchingMode matching = Christofides::MatchingMode::Exact;
+	bool localSearch = false;
+	float localSearchSeconds = 0;
+	unsigned short finish = 0;
+};
+
+sOptions ReadOptions(int argc, char **argv, int first)
+{
+	sOptions options;
+
+	auto value = [&](int &i)
+	{
+		if (++i >= argc)
+			throw invalid_argument(string("Missing value of ") + argv[i - 1]);
+
+		return string(argv[i]);
+	};
+
+	for (auto i = first; i < argc; i++)
+	{
+		const string o = argv[i];
+
+		if (o == "-threads")
+		{
+			options.threads = stoul(value(i));
+		}
+		else if (o == "-warm")
+		{
+			auto w = value(i);
+
+			if (w == "I")
+				options.warmStart = Branch_and_Bound::WarmStart::Identity;
+			else if (w == "A")
+				options.warmStart = Branch_and_Bound::WarmStart::ApproxTSP;
+			else if (w == "C")
+				options.warmStart = Branch_and_Bound::WarmStart::Christofides;
+			else
+				throw invalid_argument("Unknown warm start " + w);
+		}
+		else if (o == "-checkpoint")
+		{
+			options.checkpointFile = value(i);
+		}
+		else if (o == "-interval")
+		{
+			options.checkpointInterval = stoul(value(i));
+		}
+		else if (o == "-stats")
+		{
+			options.statisticsFile = value(i);
+		}
+		else if (o == "-trace")
+		{
+			options.traceFile = value(i);
+		}
+		else if (o == "-portfolio")
+		{
+			options.portfolio = true;
+		}
+		else if (o == "-matching")
+		{
+			auto m = value(i);
+
+			if (m == "E")
+				options.matching = Christofides::MatchingMode::Exact;
+			else if (m == "G")
+				options.matching = Christofides::MatchingMode::Greedy;
+			else
+				throw invalid_argument("Unknown matching " + m);
+		}
+		else if (o == "-ls")
+		{
+			options.localSearch = true;
+		}
+		else if (o == "-lk")
+		{
+			options.localSearch = true;
+			options.localSearchSeconds = stof(value(i));
+		}
+		else if (o == "-finish")
+		{
+			options.finish = stoul(value(i));
+		}
+		else
+		{
+			throw invalid_argument("Unknown option " + o);
+		}
+	}
+
+	return options;
+}
+
 vector<float> split(string &s, char delim)
 {
 	vector<float> elems;
@@ -41,7 +145,7 @@ vector<float> split(string &s, char delim)
 	return elems;
 }
 
-vector<vector<float>> ReadFileTSPLib(string TSPName)
+vector<vector<float>> ReadFileTSPLib(string TSPName, vector<pair<float, float>> &points)
 {
 	struct coord
 	{
@@ -98,6 +202,9 @@ vector<vector<float>> ReadFileTSPLib(string TSPName)
 		for (unsigned short y = 0; y < NumberOfNodes; y++)
 			DistanceMatrix2D[x][y] = (x == y ? FLT_MAX : coordinates[x].distance(coordinates[y]));
 
+	for (auto &c : coordinates)
+		points.push_back({ c.x, c.y });
+
 	return DistanceMatrix2D;
 }
 
@@ -137,10 +244,16 @@ vector<vector<float>> ReadFileMatrixIstance(string tipo, const unsigned short Nu
 	return DistanceMatrix2D;
 }
 
-void Run(string algo, string tipo, string TSPLibFileName, const unsigned short NumberOfNodes)
+void Run(string algo, string tipo, string TSPLibFileName, const unsigned short NumberOfNodes, const sOptions &options)
 {
 	auto type = (tipo == "A" ? "asym" : "sym");
-	auto DistanceMatrix2D = (NumberOfNodes == 0 ? ReadFileTSPLib(TSPLibFileName) : ReadFileMatrixIstance(type, NumberOfNodes));
+	vector<pair<float, float>> points;
+	auto DistanceMatrix2D = (NumberOfNodes == 0 ? ReadFileTSPLib(TSPLibFileName, points) : ReadFileMatrixIstance(type, NumberOfNodes));
+
+	unique_ptr<AscentTrace> trace;
+
+	if (!options.traceFile.empty())
+		trace.reset(new AscentTrace(options.traceFile));
 
 	if (algo == "H")
 	{
@@ -150,44 +263,79 @@ void Run(string algo, string tipo, string TSPLibFileName, const unsigned short N
 	else if (algo == "A")
 	{
 		ApproxTSP A(DistanceMatrix2D);
+		A.SetLocalSearch(options.localSearch, options.localSearchSeconds);
 		A.Run();
 	}
 	else if (algo == "B")
 	{
-		Branch_and_Bound A(DistanceMatrix2D);
+		Branch_and_Bound A(DistanceMatrix2D, options.threads, options.warmStart);
+		A.SetFinish(options.finish);
+		A.SetTrace(trace.get());
+
+		if (!options.statisticsFile.empty())
+			A.SetStatisticsFile(options.statisticsFile);
+
+		if (!options.checkpointFile.empty())
+			A.SetCheckpoint(options.checkpointFile, options.checkpointInterval);
+
 		A.Run();
 	}
+	else if (algo == "V")
+	{
+		// regression: every warm start must reach the optimum of the search started from the identity tour
+		float reference, opt;
+		string path;
+
+		Branch_and_Bound I(DistanceMatrix2D, options.threads, Branch_and_Bound::WarmStart::Identity);
+		I.SilentSolve(reference, path);
+
+		cout << "Identity: " << reference << endl;
+
+		for (const auto w : { Branch_and_Bound::WarmStart::ApproxTSP, Branch_and_Bound::WarmStart::Christofides })
+		{
+			Branch_and_Bound A(DistanceMatrix2D, options.threads, w);
+			A.SilentSolve(opt, path);
+
+			cout << (w == Branch_and_Bound::WarmStart::ApproxTSP ? "Approx-TSP: " : "Christofides: ") << opt << endl;
+
+			if (abs(opt - reference) > 1e-6f * reference)
+				throw runtime_error("The warm start changed the optimum");
+		}
+	}
 	else if (algo == "L")
 	{
-		LagrangianRelaxation A(DistanceMatrix2D);
+		LagrangianRelaxation A(DistanceMatrix2D, options.portfolio);
+		A.SetTrace(trace.get());
 		A.Run();
 	}
 	else
 	{
-		Christofides A(DistanceMatrix2D);
+		Christofides A(DistanceMatrix2D, options.matching);
+		A.SetCoordinates(points);
+		A.SetLocalSearch(options.localSearch, options.localSearchSeconds);
 		A.Run();
 	}
 }
 
-void StartElaboration_TSP(string algo, string tipo, const string graphToSolve)
+void StartElaboration_TSP(string algo, string tipo, const string graphToSolve, const sOptions &options)
 {
 	if (tipo == "T")
 	{
-		Run(algo, tipo, graphToSolve, 0);
+		Run(algo, tipo, graphToSolve, 0, options);
 	}
 	else if (graphToSolve == "all")
 	{
 		if (tipo == "E")
 			for (const auto n : { 4, 6, 10, 15, 20, 25, 100, 500, 1000 })
-				Run(algo, tipo, "", n);
+				Run(algo, tipo, "", n, options);
 		else
 			for (const auto n : { 4, 10, 15, 20, 25 })
-				Run(algo, tipo, "", n);
+				Run(algo, tipo, "", n, options);
 	}
 	else
 	{
 		unsigned short nodes = stoul(graphToSolve);
-		Run(algo, tipo, "", nodes);
+		Run(algo, tipo, "", nodes, options);
 	}
 }
 
@@ -198,9 +346,25 @@ void WriteTitle()
 		<< "Christofides algorithm, 2-approximation algorithm, Lagrangian relaxation to solve the Euclidean Traveling Salesman Problem" << endl
 		<< endl
 		<< "Program parameters:" << endl
-		<< " algorithm = {H, C, A, B, L}" << endl
+		<< " algorithm = {H, C, A, B, L, V}" << endl
 		<< " type = {E, A, T}" << endl
 		<< " [graph to solve = {4, 10, 15, 20, 25, all} OR {TSPLibFileName}]" << endl
+		<< " [options]" << endl
+		<< endl
+		<< "V solves with every warm start and fails if one of them misses the optimum found from the identity tour." << endl
+		<< endl
+		<< "Options:" << endl
+		<< " -threads n          B, V: worker threads, 0 for all the cores" << endl
+		<< " -warm {I, A, C}     B: first upper bound from identity, Approx-TSP or Christofides" << endl
+		<< " -checkpoint file    B: save the search to file and resume it from there" << endl
+		<< " -interval seconds   B: seconds between checkpoints, default 60" << endl
+		<< " -stats file         B: statistics written as JSON to file" << endl
+		<< " -finish n           B: Held-Karp closes the subproblems of at most n nodes" << endl
+		<< " -trace file         B, L: every ascent iteration written to file" << endl
+		<< " -portfolio          L: step schedules on concurrent threads" << endl
+		<< " -matching {E, G}    C: exact or greedy minimum weight matching" << endl
+		<< " -ls                 A, C: 2-opt and Or-opt on the tour" << endl
+		<< " -lk seconds         A, C: iterated Lin-Kernighan on the tour for seconds" << endl
 		<< endl
 		<< endl
 		<< "Copyright 2020 (c) [MAIONE MIKY]. All rights reserved." << endl
@@ -220,6 +384,7 @@ int main(int argc, char **argv)
 			const string algo = argv[1];
 			const string type = argv[2];
 			const string graphToSolve = argv[3];
+			const auto options = ReadOptions(argc, argv, 4);
 
 			cout << "Solving using ";
 
@@ -231,6 +396,8 @@ int main(int argc, char **argv)
 				cout << "Branch-and-Bound algorithm on ";
 			else if (algo == "L")
 				cout << "Lagrangian relaxation algorithm on ";
+			else if (algo == "V")
+				cout << "Branch-and-Bound with every warm start on ";
 			else
 				cout << "Christofides algorithm on ";
 
@@ -241,7 +408,7 @@ int main(int argc, char **argv)
 
 			cout << endl << endl;
 
-			StartElaboration_TSP(algo, type, graphToSolve);
+			StartElaboration_TSP(algo, type, graphToSolve, options);
 		}
 	}
 	catch (const exception &e)